@@ -10,11 +10,17 @@
 #include "hardware/i2c.h"           // Biblioteca para comunicação I2C  
 #include "hardware/adc.h"           // Biblioteca para leitura de ADC (joystick simulando sensor de umidade)  
 #include "hardware/timer.h"         // Biblioteca para uso de timers  
+#include "hardware/uart.h"          // Biblioteca para a UART do modem LoRa  
 
 // Bibliotecas personalizadas  
 #include "PassaOuRepassa.pio.h"     // Biblioteca PIO para controle de LEDs WS2818B  
 #include "lib/ssd1306.h"            // Biblioteca para controle do display OLED SSD1306  
 #include "lib/font.h"               // Biblioteca para manipulação de fontes no display  
+#include "lib/lora_enlace.h"        // Camada de enlace para o modem LoRa (telemetria)  
+#include "lib/detector_latas.h"     // Detecção antecipada de obstrução e sobrecarga  
+#include "lib/relogio.h"            // Gerência do clock e dos divisores dos periféricos  
+#include "lib/barramento_i2c.h"     // Escalonador do barramento I2C compartilhado  
+#include "lib/histograma.h"         // Histogramas de latência (percentis)  
 
 // Definições de constantes  
 #define BUZZER1 21              // Define o pino 21 para o Buzzer  
@@ -40,11 +46,29 @@ volatile uint32_t last_interrupt_time = 0; // Armazena o tempo da última interr
 // Variável para verificar se o botão A foi pressionado  
 volatile bool botao_A_pressionado = false;  
 
+// Escalonamento do clock: cheio com a esteira em uso, reduzido após um tempo parada  
+#define CLOCK_ATIVO_KHZ 128000  // Clock com a esteira em operação  
+#define CLOCK_OCIOSO_KHZ 48000  // Clock com a esteira parada (PIO, PWM e I2C seguem exatos)  
+#define TEMPO_OCIOSO_MS 30000   // Tempo sem atividade antes de reduzir o clock  
+volatile bool atividade = false; // Botão acionado desde a última volta do laço principal  
+
 // Definição de pinos e configurações do hardware do display OLED  
 #define I2C_PORT i2c1           // Porta I2C utilizada  
 #define I2C_SDA 14              // Pino SDA para comunicação I2C  
 #define I2C_SCL 15              // Pino SCL para comunicação I2C  
 #define endereco 0x3C           // Endereço padrão do display OLED  
+#define endereco_operador 0x3D  // Display OLED da estação do operador, no mesmo barramento  
+barramento_i2c_t barramento;    // Fila de transferências do i2c1 (displays e, futuramente, sensor)  
+barramento_display_t tela_principal, tela_operador; // Quadros enviados em segundo plano  
+uint32_t quadros_principal, quadros_operador; // Quadros entregues até o último relatório  
+
+// Modem LoRa em modo transparente (a UART0 fica com o stdio)  
+#define LORA_UART uart1         // UART ligada ao modem  
+#define LORA_TX_PIN 8           // Pino TX para o modem  
+#define LORA_RX_PIN 9           // Pino RX vindo do modem  
+#define LORA_BAUD 9600          // Velocidade padrão dos modens LoRa UART  
+#define ID_LINHA 1              // Identificação desta esteira no gateway  
+lora_enlace_t lora;             // Estado da camada de enlace  
 
 // Intervalo de amostragem para medições  
 #define INTERVALO_AMOSTRAGEM 6000  // Intervalo de 6 segundos em milissegundos  
@@ -59,6 +83,16 @@ bool inicio_esteira;  // Flag para o som e sinalização aconteça apenas ao lig
 char ultimo_estado = 'N'; // 'N' = Normal, 'A' = Alta velocidade, 'B' = Baixa velocidade  
 char estado_atual = 'N'; // Assume que está em estado normal  
 char Parada_Critica = 'N';  // Assume que não há parada crítica ('N' = Normal)  
+detector_latas_t detector;  // Estatística dos intervalos entre latas  
+volatile char alerta_detector = 'N'; // 'N' = Normal, 'o'/'s' = alerta, 'O' = parada  
+
+// Histogramas (em µs) do intervalo entre latas e da duração de cada volta do laço principal  
+#define HISTOGRAMA_ACUMULAR true    // true: junta cada período ao total desde a partida; false: só o período  
+histograma_t hist_latas[2], hist_laco;          // Período atual (zerados a cada relatório); latas em buffer duplo  
+volatile uint8_t hist_latas_ativo = 0;           // Metade de hist_latas em que a interrupção do sensor registra  
+volatile bool relatorio_pendente = false;        // Relatório serial pedido pelo temporizador, impresso no laço principal  
+histograma_t hist_latas_total, hist_laco_total; // Acumulado desde a partida  
+uint64_t ultima_lata_us = 0;    // Instante da última lata, para o intervalo  
 float media;              // Média de velocidade da esteira  
 float velocidade_E = 5.6; // Velocidade inicial da esteira (m/s)  
 const float espacamento = 0.085; // Espaçamento entre as latas (6.5 cm diâmetro + 2 cm espaçamento = 8.5 cm = 0.085 m)  
@@ -154,7 +188,7 @@ void desenho_pio(PIO pio, uint sm) {
     apagar_matrizLEDS(pio, sm);
 }
 
-// Controla a animação da matriz de LEDs simulando um efeito visual de transmição de dados por LoRa.
+// Controla a animação da matriz de LEDs sinalizando a transmissão de dados por LoRa.
 void desenhoLora_pio(PIO pio, uint sm) {
     uint32_t leds[LED_COUNT] = {0}; // Inicializa todos os LEDs apagados
 
@@ -240,18 +274,85 @@ void tratar_parada_critica(char Parada_Critica) {
         stop_buzzer(BUZZER1);
         sleep_ms(100);
     }                 
-    desenhoLora_pio(pio, sm); // envia status pelo LORA para tomar medidas
+    lora_enlace_evento(&lora, to_ms_since_boot(get_absolute_time()), Parada_Critica); // envia status pelo LORA para tomar medidas
+    desenhoLora_pio(pio, sm);
 }
 
-// Função chamada periodicamente pelo temporizador para exibir a contagem de latas.
-bool callback_temporizador(struct repeating_timer *t) {
+// Recomeça o detector com a velocidade atual da esteira (a interrupção do sensor também o altera)
+void reiniciar_detector() {
+    uint32_t irq = save_and_disable_interrupts();
+    detector_ajustar_esteira(&detector, espacamento, velocidade_E);
+    detector_reiniciar(&detector, time_us_64());
+    restore_interrupts(irq);
+}
+
+// Troca de velocidade: só o espaçamento mínimo entre latas muda, a evidência acumulada continua
+void ajustar_velocidade_detector() {
+    uint32_t irq = save_and_disable_interrupts();
+    detector_ajustar_esteira(&detector, espacamento, velocidade_E);
+    restore_interrupts(irq);
+}
+
+// Adaptadores para o gerente de clock: nenhuma transferência I2C atravessa a troca de clock
+void pausar_barramento(void *ctx) {
+    barramento_i2c_pausar((barramento_i2c_t *)ctx);
+}
+
+void retomar_barramento(uint32_t clk_sys_hz, void *ctx) {
+    barramento_i2c_retomar((barramento_i2c_t *)ctx);
+}
+
+// Imprime p50/p90/p99/máx (ms) do período e, se acumulando, o total desde a partida; zera o período
+void relatar_histograma(const char *nome, histograma_t *periodo, histograma_t *total) {
+    histograma_resumo_t r;
+    histograma_resumo(periodo, &r);
+    printf("%s (%lu amostras): p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, máx %.1f ms\n", nome, (unsigned long)r.total,
+           r.p50 / 1000.0, r.p90 / 1000.0, r.p99 / 1000.0, r.maximo / 1000.0);
+    if (HISTOGRAMA_ACUMULAR) {
+        histograma_mesclar(total, periodo);
+        histograma_resumo(total, &r);
+        printf("  desde a partida (%lu amostras): p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, máx %.1f ms\n", (unsigned long)r.total,
+               r.p50 / 1000.0, r.p90 / 1000.0, r.p99 / 1000.0, r.maximo / 1000.0);
+    }
+    histograma_zerar(periodo);
+}
+
+// Quadros entregues e pulados por display; um display sem quadros novos fica congelado
+void relatar_display(const char *nome, barramento_display_t *tela, uint32_t *anterior) {
+    uint32_t quadros = tela->quadros;
+    printf("%s: %lu quadros (%lu no período), %lu pulados\n", nome, (unsigned long)quadros,
+           (unsigned long)(quadros - *anterior), (unsigned long)tela->pulados);
+    if (quadros == *anterior)
+        printf("AVISO: %s sem quadro novo no período\n", nome);
+    *anterior = quadros;
+}
+
+// Relatório periódico na serial. Roda no laço principal: percentis e printf dentro da
+// interrupção atrasariam a do sensor de latas e distorceriam os intervalos medidos.
+void relatar_sistema() {
+    // Troca a metade do histograma de latas em uso pela interrupção e relata a outra
+    uint32_t irq = save_and_disable_interrupts();
+    histograma_t *latas_periodo = &hist_latas[hist_latas_ativo];
+    hist_latas_ativo ^= 1;
+    restore_interrupts(irq);
+
     printf("\n====== Atualização do sistema ======\n");
     printf("Latas detectadas nos últimos 6 segundos: %d\n", contador_latas);
     printf("Velocidade da esteira: %.2f m/s\n", velocidade_E);
     printf("Taxa de passagem: %.2f latas/s\n", media);
     printf("Nível de umidade: %d%%\n", umidade);
     printf("Velocidade da esteira (N-Normal, A-Alta, B-Baixa): %c\n", estado_atual);
+    printf("Detector (N-Normal, o/s-Alerta, O-Parada): %c\n", alerta_detector);
+    relatar_histograma("Intervalo entre latas", latas_periodo, &hist_latas_total);
+    relatar_histograma("Volta do laço principal", &hist_laco, &hist_laco_total);
+    relatar_display("Display principal", &tela_principal, &quadros_principal);
+    relatar_display("Display do operador", &tela_operador, &quadros_operador);
     printf("========================================================\n\n");    
+}
+
+// Função chamada periodicamente pelo temporizador: só sinaliza o laço principal.
+bool callback_temporizador(struct repeating_timer *t) {
+    relatorio_pendente = true;
     calcular_media = true;
     return true;
 }
@@ -262,9 +363,17 @@ void gpio_irq_handler(uint gpio, uint32_t events) {
 
     if (current_time - last_interrupt_time > DEBOUNCE_DELAY) {
         last_interrupt_time = current_time;
+        atividade = true;
 
         if (gpio == Botao_A) {
             contador_latas++;
+            uint64_t agora_us = time_us_64();
+            if (ultima_lata_us) {
+                uint64_t intervalo = agora_us - ultima_lata_us;
+                histograma_registrar(&hist_latas[hist_latas_ativo], intervalo > UINT32_MAX ? UINT32_MAX : (uint32_t)intervalo);
+            }
+            ultima_lata_us = agora_us;
+            detector_lata(&detector, agora_us);
             botao_A_pressionado = true;
         }else if(gpio == Botao_B){
             if(!iniciar_esteira){ // se tenho que ativar a esteira entra no loop
@@ -281,6 +390,7 @@ void gpio_irq_handler(uint gpio, uint32_t events) {
                 Parada_Critica= 'N';  // Assume que está normal
                 iniciar_esteira=true; //!iniciar_esteira; oi2
                 contador_latas = 0;
+                ultima_lata_us = 0;  // O primeiro intervalo não inclui o tempo parado
                 umidade=50;
             }else{                             
                 Parada_Critica='B';
@@ -292,6 +402,8 @@ void gpio_irq_handler(uint gpio, uint32_t events) {
 
 int main() {
     stdio_init_all(); // Inicializa a comunicação serial
+    bool ok = relogio_definir_khz(CLOCK_ATIVO_KHZ); // Configura o clock para 128 MHz
+    relogio_registrar_uart(uart_default, PICO_DEFAULT_UART_BAUD_RATE); // stdio pela UART0
     char buffer[20]; // Buffer para armazenar a string formatada no display
 
     // Configuração do PWM para o BUZZER1
@@ -299,7 +411,7 @@ int main() {
     gpio_init(BUZZER1);
     gpio_set_dir(BUZZER1, GPIO_OUT);
     gpio_set_function(BUZZER1, GPIO_FUNC_PWM); // Configura o GPIO como PWM
-    pwm_set_clkdiv(slice_num, 125.0f);     // Define o divisor do clock para 1 MHz
+    relogio_registrar_pwm(slice_num, 1000000); // Define o divisor do clock para 1 MHz
     pwm_set_wrap(slice_num, 1000);        // Define o TOP para frequência de 1 kHz
     pwm_set_chan_level(slice_num, pwm_gpio_to_channel(BUZZER1), 0); // Razão cíclica inicial
     pwm_set_enabled(slice_num, true);     // Habilita o PWM    
@@ -309,14 +421,28 @@ int main() {
     uint led_slice_num = pwm_gpio_to_slice_num(LED_B_PIN);
     uint led_channel = pwm_gpio_to_channel(LED_B_PIN);
     pwm_set_wrap(led_slice_num, 1000);
-    pwm_set_clkdiv(led_slice_num, 125.0f);
+    relogio_registrar_pwm(led_slice_num, 1000000);
     pwm_set_enabled(led_slice_num, true);
 
+    // Configuração da UART do modem LoRa
+    uart_init(LORA_UART, LORA_BAUD);
+    relogio_registrar_uart(LORA_UART, LORA_BAUD);
+    gpio_set_function(LORA_TX_PIN, GPIO_FUNC_UART);
+    gpio_set_function(LORA_RX_PIN, GPIO_FUNC_UART);
+    lora_config_t lora_cfg;
+    lora_config_padrao(&lora_cfg, ID_LINHA);
+    lora_transporte_t lora_uart;
+    lora_transporte_uart(&lora_uart, LORA_UART);
+    lora_enlace_init(&lora, &lora_cfg, &lora_uart);
+
     // Configuração do ADC do Joystick - sensor de umidade
     adc_init();
     adc_gpio_init(JOYSTICK_X_PIN);
     uint16_t adc_value_x;
 
+    // Detector com a mesma faixa de taxa usada no ajuste de velocidade
+    detector_init(&detector, 0.25, 0.5);
+
     // Configuração dos botões
     gpio_init(Botao_B);
     gpio_set_dir(Botao_B, GPIO_IN);
@@ -331,8 +457,6 @@ int main() {
     gpio_set_dir(LED_R_PIN, GPIO_OUT);
     gpio_put(LED_R_PIN, false); 
 
-    bool ok;
-    ok = set_sys_clock_khz(128000, false); // Configura o clock para 128 MHz
     printf("iniciando a transmissão PIO");
     if (ok) printf("clock set to %ld\n", clock_get_hz(clk_sys));
 
@@ -340,9 +464,11 @@ int main() {
     uint offset = pio_add_program(pio, &PassaOuRepassa_program);
     sm = pio_claim_unused_sm(pio, true);
     PassaOuRepassa_program_init(pio, sm, offset, LED_PIN);
+    relogio_registrar_pio(pio, sm, 8000000); // 8 MHz, 10 ciclos por bit dos LEDs
 
     // Inicialização do I2C para o display 400Khz.
     i2c_init(I2C_PORT, 400 * 1000);
+    relogio_registrar_i2c(I2C_PORT, 400 * 1000);
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C); // Configura o pono GPIO para I2C
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C); // Configura o pono GPIO para I2C
     gpio_pull_up(I2C_SDA);                     // Linha de dados
@@ -357,6 +483,25 @@ int main() {
     ssd1306_fill(&ssd, false);
     ssd1306_send_data(&ssd);
 
+    ssd1306_t ssd_operador; // Segundo display, na estação do operador
+    ssd1306_init(&ssd_operador, WIDTH, HEIGHT, false, endereco_operador, I2C_PORT);
+    ssd1306_config(&ssd_operador);
+    ssd1306_fill(&ssd_operador, false);
+    ssd1306_send_data(&ssd_operador);
+
+    // A partir daqui o i2c1 é usado só pelo escalonador, sem chamadas bloqueantes
+    barramento_i2c_init(&barramento, I2C_PORT);
+    relogio_registrar(pausar_barramento, retomar_barramento, &barramento);
+    barramento_display_init(&tela_principal, &barramento, &ssd, BARRAMENTO_PRIORIDADE_BAIXA);
+    barramento_display_init(&tela_operador, &barramento, &ssd_operador, BARRAMENTO_PRIORIDADE_BAIXA);
+
+    // Histogramas vazios antes de habilitar as interrupções que os alimentam
+    histograma_zerar(&hist_latas[0]);
+    histograma_zerar(&hist_latas[1]);
+    histograma_zerar(&hist_laco);
+    histograma_zerar(&hist_latas_total);
+    histograma_zerar(&hist_laco_total);
+
     //Temporizador para cálculo de velocidade
     struct repeating_timer timer;
     add_repeating_timer_ms(INTERVALO_AMOSTRAGEM, callback_temporizador, NULL, &timer);
@@ -365,7 +510,25 @@ int main() {
     gpio_set_irq_enabled_with_callback(Botao_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
     gpio_set_irq_enabled_with_callback(Botao_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
 
+    relogio_ocioso_config(CLOCK_ATIVO_KHZ, CLOCK_OCIOSO_KHZ, TEMPO_OCIOSO_MS);
+    relogio_atividade(to_ms_since_boot(get_absolute_time()));
+
     while (true) {
+        // Antes da medição da volta: o relatório não entra no histograma do laço
+        if (relatorio_pendente) {
+            relatorio_pendente = false;
+            relatar_sistema();
+        }
+        uint64_t inicio_laco_us = time_us_64();
+
+        // Esteira em operação ou botão acionado mantêm o clock cheio; parada, o clock é reduzido
+        if (atividade || iniciar_esteira) {
+            atividade = false;
+            relogio_atividade(to_ms_since_boot(get_absolute_time()));
+        }
+        relogio_tarefa(to_ms_since_boot(get_absolute_time()));
+
+        lora_enlace_tarefa(&lora, to_ms_since_boot(get_absolute_time())); // ACKs, retransmissões e envio da fila
         if(botao_A_pressionado == true){
             desenho_pio(pio, sm);
             botao_A_pressionado =false;
@@ -382,10 +545,24 @@ int main() {
                     som_inicio_atividades();
                     acender_sinal_inicio();
                     pwm_set_chan_level(led_slice_num, led_channel, 500); // PWM na velocidade media
+                    reiniciar_detector();
+                }
+
+                // Detector de intervalos: para antes das duas janelas se a falta de latas já é improvável.
+                // A sobrecarga só gera alerta: em tráfego aleatório a regra das janelas é mais rápida (veja o README)
+                uint32_t irq = save_and_disable_interrupts();
+                detector_estado_t alerta = detector_avaliar(&detector, time_us_64());
+                restore_interrupts(irq);
+                alerta_detector = "NosOs"[alerta]; // Na ordem de detector_estado_t
+                if (alerta == DETECTOR_OBSTRUCAO) {
+                    Parada_Critica = alerta_detector;
+                    pwm_set_chan_level(led_slice_num, led_channel, 0); // desliga servo motor
+                    tratar_parada_critica(Parada_Critica);
                 }
                 if (calcular_media) {
                     calcular_media = false;  // Resetar flag
-                    media = (float)contador_latas / (INTERVALO_AMOSTRAGEM / 1000);  // Divide pelo tempo em segundos
+                    int latas = contador_latas;
+                    media = (float)latas / (INTERVALO_AMOSTRAGEM / 1000);  // Divide pelo tempo em segundos
                     contador_latas = 0;
                     
                     if (media < 0.25) {  // se é menor que 1 lata cada 4 segundos
@@ -437,8 +614,16 @@ int main() {
                         tratar_parada_critica(Parada_Critica);
                         ssd1306_draw_string(&ssd, "PARADA CRITICA", 8, 50);
                     }
+                    // Nova velocidade muda o espaçamento mínimo entre latas no detector
+                    if (estado_atual != ultimo_estado) {
+                        ajustar_velocidade_detector();
+                    }
+
                     // Atualiza o último estado e o tempo de ajuste
                     ultimo_estado = estado_atual;
+
+                    // Agrega a medição no próximo pacote LoRa
+                    lora_enlace_estatistica(&lora, to_ms_since_boot(get_absolute_time()), latas, media, velocidade_E, umidade, estado_atual);
                 }
 
                 // Atualiza o display
@@ -451,6 +636,8 @@ int main() {
                 sprintf(buffer, "V. Est.:%.2f", velocidade_E);
                 ssd1306_draw_string(&ssd, buffer, 8, 28);
                 if(!iniciar_esteira){ssd1306_draw_string(&ssd, "PARADA CRITICA", 8, 50);}
+                else if(alerta_detector == 'o'){ssd1306_draw_string(&ssd, "ALERTA OBSTR.", 8, 50);}
+                else if(alerta_detector == 's'){ssd1306_draw_string(&ssd, "ALERTA SOBREC.", 8, 50);}
                 ssd1306_rect(&ssd, 3, 3, 122, 60, true, false);
             
             }
@@ -470,8 +657,26 @@ int main() {
                 ssd1306_draw_string(&ssd, "PARADA CRITICA", 8, 50);                  
                 ssd1306_draw_string(&ssd, " * ", 90, 38); //*=Critica
                 }
-            ssd1306_send_data(&ssd); // Desenha no display
+
+            // Display do operador: resumo da estação
+            ssd1306_fill(&ssd_operador, false);
+            ssd1306_draw_string(&ssd_operador, "Operador", 32, 6);
+            sprintf(buffer, "Estado: %c", estado_atual);
+            ssd1306_draw_string(&ssd_operador, buffer, 8, 20);
+            sprintf(buffer, "Taxa:%.2f", media);
+            ssd1306_draw_string(&ssd_operador, buffer, 8, 32);
+            if(!iniciar_esteira){ssd1306_draw_string(&ssd_operador, "PARADA CRITICA", 8, 50);}
+            else if(alerta_detector == 'o'){ssd1306_draw_string(&ssd_operador, "ALERTA OBSTR.", 8, 50);}
+            else if(alerta_detector == 's'){ssd1306_draw_string(&ssd_operador, "ALERTA SOBREC.", 8, 50);}
+            ssd1306_rect(&ssd_operador, 3, 3, 122, 60, true, false);
+
+            // Desenha nos displays em segundo plano (se o quadro anterior ainda está saindo, este é pulado)
+            barramento_i2c_enviar_display(&tela_principal);
+            barramento_i2c_enviar_display(&tela_operador);
         }
+
+        // Duração do trabalho da volta (sem a pausa fixa nem o relatório)
+        histograma_registrar(&hist_laco, (uint32_t)(time_us_64() - inicio_laco_us));
         sleep_ms(100); 
     }
     sleep_ms(10);
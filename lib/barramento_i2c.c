@@ -0,0 +1,287 @@
+#include <string.h>
+#include "barramento_i2c.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define BARRAMENTO_FIFO 16  // Profundidade das FIFOs de TX e RX do controlador
+
+static barramento_i2c_t *instancias[2];
+
+static void iniciar_proxima(barramento_i2c_t *b);
+
+// Coloca comandos na FIFO de TX enquanto houver espaço. Leituras pendentes ficam
+// limitadas à profundidade da FIFO de RX para nenhum byte recebido ser perdido.
+static void bombear(barramento_i2c_t *b) {
+  i2c_hw_t *hw = i2c_get_hw(b->i2c);
+  const barramento_transferencia_t *t = &b->fila[b->atual];
+
+  while (!b->falhou && b->cmd < b->total && hw->txflr < BARRAMENTO_FIFO) {
+    uint32_t dc;
+    if (b->cmd < b->escritas) {
+      uint16_t i = b->cmd - (t->tem_prefixo ? 1 : 0);
+      dc = (t->tem_prefixo && b->cmd == 0) ? t->prefixo : t->tx[i];
+    } else {
+      if ((uint16_t)(b->cmd - b->escritas) - b->rx_pos >= BARRAMENTO_FIFO) {
+        hw->intr_mask &= ~I2C_IC_INTR_MASK_M_TX_EMPTY_BITS; // Volta quando a RX for lida
+        return;
+      }
+      dc = I2C_IC_DATA_CMD_CMD_BITS;
+      if (b->cmd == b->escritas && b->escritas > 0)
+        dc |= I2C_IC_DATA_CMD_RESTART_BITS;
+    }
+    if (b->cmd == b->total - 1)
+      dc |= I2C_IC_DATA_CMD_STOP_BITS;
+    hw->data_cmd = dc;
+    b->cmd++;
+  }
+  if (b->falhou || b->cmd == b->total)
+    hw->intr_mask &= ~I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+}
+
+static void drenar(barramento_i2c_t *b) {
+  i2c_hw_t *hw = i2c_get_hw(b->i2c);
+  barramento_transferencia_t *t = &b->fila[b->atual];
+  while (hw->rxflr) {
+    uint8_t v = (uint8_t)hw->data_cmd;
+    if (b->rx_pos < t->rx_len)
+      t->rx[b->rx_pos++] = v;
+  }
+  if (!b->falhou && b->cmd < b->total)
+    hw->intr_mask |= I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+}
+
+static void concluir(barramento_i2c_t *b) {
+  barramento_transferencia_t *t = &b->fila[b->atual];
+  bool ok = !b->falhou && b->rx_pos == t->rx_len;
+  t->ocupado = false;
+  b->atual = -1;
+  if (t->concluido)
+    t->concluido(ok, t->ctx);
+  if (b->atual < 0) // O retorno pode ter enfileirado e iniciado outra transferência
+    iniciar_proxima(b);
+}
+
+static void tratar_irq(barramento_i2c_t *b) {
+  i2c_hw_t *hw = i2c_get_hw(b->i2c);
+  uint32_t stat = hw->intr_stat;
+
+  if (b->atual < 0) {
+    hw->intr_mask = 0;
+    (void)hw->clr_intr;
+    return;
+  }
+  if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+    (void)hw->clr_tx_abrt; // NACK ou perda de arbitragem: o controlador esvazia a FIFO e gera STOP
+    b->falhou = true;
+    hw->intr_mask &= ~I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+  }
+  if (stat & I2C_IC_INTR_STAT_R_RX_FULL_BITS)
+    drenar(b);
+  if (stat & I2C_IC_INTR_STAT_R_TX_EMPTY_BITS)
+    bombear(b);
+  if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+    (void)hw->clr_stop_det;
+    drenar(b);
+    concluir(b);
+  }
+}
+
+static void irq_i2c0(void) { tratar_irq(instancias[0]); }
+static void irq_i2c1(void) { tratar_irq(instancias[1]); }
+
+// Escolhe a transferência de maior prioridade; entre iguais, a mais antiga.
+// Chamada com as interrupções do barramento inibidas (ou dentro delas).
+static void iniciar_proxima(barramento_i2c_t *b) {
+  i2c_hw_t *hw = i2c_get_hw(b->i2c);
+  int escolhida = -1;
+  if (!b->pausado) {
+    for (int i = 0; i < BARRAMENTO_MAX_TRANSFERENCIAS; ++i) {
+      const barramento_transferencia_t *t = &b->fila[i];
+      if (!t->ocupado)
+        continue;
+      if (escolhida < 0 || t->prioridade > b->fila[escolhida].prioridade ||
+          (t->prioridade == b->fila[escolhida].prioridade && (int32_t)(t->ordem - b->fila[escolhida].ordem) < 0))
+        escolhida = i;
+    }
+  }
+  if (escolhida < 0) {
+    hw->intr_mask = 0;
+    return;
+  }
+
+  const barramento_transferencia_t *t = &b->fila[escolhida];
+  b->atual = escolhida;
+  b->escritas = t->tx_len + (t->tem_prefixo ? 1 : 0);
+  b->total = b->escritas + t->rx_len;
+  b->cmd = 0;
+  b->rx_pos = 0;
+  b->falhou = false;
+
+  // O endereço do escravo só pode ser trocado com o controlador desabilitado
+  hw->enable = 0;
+  hw->tar = t->endereco;
+  hw->enable = 1;
+  (void)hw->clr_intr;
+
+  hw->intr_mask = I2C_IC_INTR_MASK_M_TX_EMPTY_BITS | I2C_IC_INTR_MASK_M_STOP_DET_BITS |
+                  I2C_IC_INTR_MASK_M_TX_ABRT_BITS | (t->rx_len ? I2C_IC_INTR_MASK_M_RX_FULL_BITS : 0);
+  bombear(b);
+}
+
+void barramento_i2c_init(barramento_i2c_t *b, i2c_inst_t *i2c) {
+  memset(b, 0, sizeof(*b));
+  b->i2c = i2c;
+  b->atual = -1;
+
+  i2c_hw_t *hw = i2c_get_hw(i2c);
+  hw->intr_mask = 0;
+  hw->tx_tl = BARRAMENTO_FIFO / 2;  // Reabastece com metade da FIFO ainda por enviar
+  hw->rx_tl = 0;                    // Cada byte recebido gera interrupção
+
+  uint indice = i2c_hw_index(i2c);
+  instancias[indice] = b;
+  irq_set_exclusive_handler(I2C0_IRQ + indice, indice ? irq_i2c1 : irq_i2c0);
+  irq_set_enabled(I2C0_IRQ + indice, true);
+}
+
+// Enfileira n transferências de uma vez (todas ou nenhuma), na ordem dada. Uma
+// transferência sem nenhum byte não geraria STOP e prenderia o barramento: é recusada.
+bool barramento_i2c_enfileirar(barramento_i2c_t *b, const barramento_transferencia_t *t, uint n) {
+  for (uint i = 0; i < n; ++i)
+    if (t[i].tx_len == 0 && t[i].rx_len == 0 && !t[i].tem_prefixo)
+      return false;
+
+  uint32_t irq = save_and_disable_interrupts();
+
+  uint livres = 0;
+  for (int i = 0; i < BARRAMENTO_MAX_TRANSFERENCIAS; ++i)
+    livres += !b->fila[i].ocupado;
+  if (livres < n) {
+    restore_interrupts(irq);
+    return false;
+  }
+
+  for (int i = 0; n > 0 && i < BARRAMENTO_MAX_TRANSFERENCIAS; ++i) {
+    if (b->fila[i].ocupado)
+      continue;
+    b->fila[i] = *t++;
+    b->fila[i].ocupado = true;
+    b->fila[i].ordem = b->proxima_ordem++;
+    n--;
+  }
+  if (b->atual < 0)
+    iniciar_proxima(b);
+
+  restore_interrupts(irq);
+  return true;
+}
+
+// Varre a fila com as interrupções inibidas: um bloco de display concluído é trocado
+// pelo seguinte dentro da interrupção, possivelmente em uma posição já varrida
+bool barramento_i2c_ocioso(barramento_i2c_t *b) {
+  uint32_t irq = save_and_disable_interrupts();
+  bool ocioso = true;
+  for (int i = 0; ocioso && i < BARRAMENTO_MAX_TRANSFERENCIAS; ++i)
+    ocioso = !b->fila[i].ocupado;
+  restore_interrupts(irq);
+  return ocioso;
+}
+
+void barramento_i2c_aguardar(barramento_i2c_t *b) {
+  while (!barramento_i2c_ocioso(b))
+    tight_loop_contents();
+}
+
+// Termina a transferência em curso e segura as demais (ex.: troca de clock)
+void barramento_i2c_pausar(barramento_i2c_t *b) {
+  b->pausado = true;
+  while (b->atual >= 0)
+    tight_loop_contents();
+}
+
+void barramento_i2c_retomar(barramento_i2c_t *b) {
+  uint32_t irq = save_and_disable_interrupts();
+  b->pausado = false;
+  if (b->atual < 0)
+    iniciar_proxima(b);
+  restore_interrupts(irq);
+}
+
+void barramento_display_init(barramento_display_t *d, barramento_i2c_t *b, ssd1306_t *ssd, uint8_t prioridade) {
+  d->ssd = ssd;
+  d->barramento = b;
+  d->prioridade = prioridade;
+  d->tam = 0;
+  d->pos = 0;
+  d->enviando = false;
+  d->quadros = 0;
+  d->pulados = 0;
+
+  // Byte de controle 0x00 seguido da janela de endereçamento completa
+  d->comandos[0] = 0x00;
+  d->comandos[1] = SET_COL_ADDR;
+  d->comandos[2] = 0;
+  d->comandos[3] = ssd->width - 1;
+  d->comandos[4] = SET_PAGE_ADDR;
+  d->comandos[5] = 0;
+  d->comandos[6] = ssd->pages - 1;
+}
+
+static void bloco_concluido(bool ok, void *ctx);
+
+// Enfileira o próximo bloco de dados do quadro
+static bool enfileirar_bloco(barramento_display_t *d) {
+  uint16_t n = d->tam - d->pos < BARRAMENTO_BLOCO ? d->tam - d->pos : BARRAMENTO_BLOCO;
+  barramento_transferencia_t t = {
+    .endereco = d->ssd->address, .prioridade = d->prioridade,
+    .tem_prefixo = true, .prefixo = 0x40,
+    .tx = &d->quadro[d->pos], .tx_len = n,
+    .concluido = bloco_concluido, .ctx = d
+  };
+  if (!barramento_i2c_enfileirar(d->barramento, &t, 1))
+    return false;
+  d->pos += n;
+  return true;
+}
+
+// Na interrupção: a posição do bloco que terminou acabou de ser liberada
+// Um bloco com falha (display ausente ou NACK) encerra o quadro, contado como pulado
+static void bloco_concluido(bool ok, void *ctx) {
+  barramento_display_t *d = (barramento_display_t *)ctx;
+  if (ok && d->pos < d->tam && enfileirar_bloco(d))
+    return;
+  if (ok && d->pos >= d->tam)
+    d->quadros++;
+  else
+    d->pulados++;
+  d->enviando = false;
+}
+
+// Copia o quadro e começa o envio pela janela de endereçamento. Com o anterior ainda
+// em envio, este é pulado (retorna false) e o laço principal segue sem esperar.
+bool barramento_i2c_enviar_display(barramento_display_t *d) {
+  if (d->enviando) {
+    d->pulados++;
+    return false;
+  }
+
+  size_t tam = d->ssd->bufsize - 1;
+  if (tam > sizeof(d->quadro))
+    tam = sizeof(d->quadro);
+  memcpy(d->quadro, &d->ssd->ram_buffer[1], tam);
+  d->tam = tam;
+  d->pos = 0;
+
+  barramento_transferencia_t t = {
+    .endereco = d->ssd->address, .prioridade = d->prioridade,
+    .tx = d->comandos, .tx_len = sizeof(d->comandos),
+    .concluido = bloco_concluido, .ctx = d
+  };
+  d->enviando = true;
+  if (!barramento_i2c_enfileirar(d->barramento, &t, 1)) {
+    d->enviando = false;
+    d->pulados++;
+    return false;
+  }
+  return true;
+}
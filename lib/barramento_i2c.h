@@ -0,0 +1,80 @@
+#ifndef BARRAMENTO_I2C_H
+#define BARRAMENTO_I2C_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+
+// Escalonador de um barramento I2C compartilhado. Cada transferência entra em uma fila
+// com prioridade e é executada em segundo plano pela interrupção do controlador I2C,
+// sem bloquear quem a pediu. Quadros de display são quebrados em blocos, de modo que
+// uma leitura de sensor de prioridade maior passa à frente entre um bloco e outro.
+
+#define BARRAMENTO_MAX_TRANSFERENCIAS 24
+#define BARRAMENTO_BLOCO 64   // Bytes de dados por transação de quadro (~1,5 ms a 400 kHz)
+
+typedef enum {
+  BARRAMENTO_PRIORIDADE_BAIXA = 0,   // Quadros de display
+  BARRAMENTO_PRIORIDADE_NORMAL,
+  BARRAMENTO_PRIORIDADE_ALTA         // Leituras de sensor
+} barramento_prioridade_t;
+
+// Chamada na interrupção ao fim da transferência
+typedef void (*barramento_concluido_t)(bool ok, void *ctx);
+
+typedef struct {
+  uint8_t endereco;
+  uint8_t prioridade;
+  bool tem_prefixo;             // Byte enviado antes de tx (ex.: 0x40, dados do SSD1306)
+  uint8_t prefixo;
+  const uint8_t *tx;            // Precisa continuar válido até a conclusão
+  uint16_t tx_len;
+  uint8_t *rx;                  // Lido após repeated start, se rx_len > 0
+  uint16_t rx_len;
+  barramento_concluido_t concluido;
+  void *ctx;
+
+  // Uso interno
+  bool ocupado;
+  uint32_t ordem;
+} barramento_transferencia_t;
+
+typedef struct {
+  i2c_inst_t *i2c;
+  barramento_transferencia_t fila[BARRAMENTO_MAX_TRANSFERENCIAS];
+  uint32_t proxima_ordem;
+  volatile int atual;           // Índice na fila, -1 com o barramento livre
+  volatile bool pausado;
+
+  // Progresso da transferência atual, em comandos do registrador DATA_CMD
+  uint16_t escritas, total, cmd, rx_pos;
+  bool falhou;
+} barramento_i2c_t;
+
+// Display SSD1306 atendido pelo escalonador, com cópia própria do quadro em envio.
+// Cada display ocupa uma só posição da fila: o próximo bloco entra quando o anterior
+// termina, e vários displays se alternam no barramento bloco a bloco.
+typedef struct {
+  ssd1306_t *ssd;
+  barramento_i2c_t *barramento;
+  uint8_t prioridade;
+  uint8_t comandos[7];
+  uint8_t quadro[WIDTH * HEIGHT / 8];
+  uint16_t tam, pos;            // Bytes do quadro e início do próximo bloco
+  volatile bool enviando;
+
+  // Diagnóstico: quadros que chegaram inteiros e quadros pulados ou interrompidos por falha
+  volatile uint32_t quadros, pulados;
+} barramento_display_t;
+
+void barramento_i2c_init(barramento_i2c_t *b, i2c_inst_t *i2c);
+bool barramento_i2c_enfileirar(barramento_i2c_t *b, const barramento_transferencia_t *t, uint n);
+bool barramento_i2c_ocioso(barramento_i2c_t *b);
+void barramento_i2c_aguardar(barramento_i2c_t *b);
+void barramento_i2c_pausar(barramento_i2c_t *b);
+void barramento_i2c_retomar(barramento_i2c_t *b);
+
+void barramento_display_init(barramento_display_t *d, barramento_i2c_t *b, ssd1306_t *ssd, uint8_t prioridade);
+bool barramento_i2c_enviar_display(barramento_display_t *d);
+
+#endif
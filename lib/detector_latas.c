@@ -0,0 +1,93 @@
+#include <math.h>
+#include "detector_latas.h"
+
+#define DETECTOR_ALFA 0.0625f      // Peso da média móvel (~16 intervalos)
+#define DETECTOR_AQUECIMENTO 8     // Intervalos antes de confiar na dispersão observada
+#define DETECTOR_FOLGA 0.5f        // Folga do CUSUM normalizado, em desvios-padrão
+
+void detector_init(detector_latas_t *d, float taxa_baixa, float taxa_alta) {
+  d->taxa_baixa = taxa_baixa;
+  d->taxa_alta = taxa_alta;
+  d->intervalo_minimo_s = 0.0f;
+
+  d->limiar_pre = 2.3f;    // ln(10)
+  d->limiar_parada = 4.6f; // ln(100)
+  d->k_pre = 3.0f;
+  d->k_parada = 5.0f;
+
+  // Obstrução: taxa_baixa contra metade dela; sobrecarga: taxa_alta contra o dobro
+  d->ln_o = logf(0.5f);
+  d->delta_o = -0.5f * taxa_baixa;
+  d->ln_s = logf(2.0f);
+  d->delta_s = taxa_alta;
+
+  // Parte do meio da faixa, com a dispersão de chegadas aleatórias (Poisson)
+  d->media_s = 2.0f / (taxa_baixa + taxa_alta);
+  d->var_s2 = d->media_s * d->media_s;
+  d->amostras = 0;
+
+  detector_reiniciar(d, 0);
+}
+
+// Esteira (re)ligada: recomeça as somas e o intervalo aberto
+void detector_reiniciar(detector_latas_t *d, uint64_t agora_us) {
+  d->cusum_o = 0.0f;
+  d->cusum_s = 0.0f;
+  d->cusum_n = 0.0f;
+  d->ultima_us = agora_us;
+}
+
+// Velocidade alterada: as taxas limite são em latas/s e não dependem da esteira, então
+// somas e intervalo aberto continuam valendo; só o menor intervalo possível muda
+void detector_ajustar_esteira(detector_latas_t *d, float espacamento, float velocidade) {
+  d->intervalo_minimo_s = velocidade > 0.0f ? espacamento / velocidade : 0.0f;
+}
+
+// Chamada na interrupção do sensor: O(1), sem alocação
+void detector_lata(detector_latas_t *d, uint64_t agora_us) {
+  float x = (float)(agora_us - d->ultima_us) * 1e-6f;
+  if (x < d->intervalo_minimo_s)
+    return; // Mais perto que o espaçamento das latas: repique do sensor
+
+  // Log-verossimilhança de um intervalo x exponencial: ln(taxa1/taxa0) - (taxa1 - taxa0) x
+  d->cusum_o = fmaxf(0.0f, d->cusum_o + d->ln_o - d->delta_o * x);
+  d->cusum_s = fmaxf(0.0f, d->cusum_s + d->ln_s - d->delta_s * x);
+
+  // Intervalos mais curtos que 1/taxa_alta, medidos no desvio-padrão observado
+  if (d->amostras >= DETECTOR_AQUECIMENTO)
+    d->cusum_n = fmaxf(0.0f, d->cusum_n + (1.0f / d->taxa_alta - x) / sqrtf(d->var_s2) - DETECTOR_FOLGA);
+
+  // Enquanto há indício de sobrecarga a referência fica congelada, senão a própria
+  // mudança infla o desvio-padrão e atrasa a detecção
+  if (d->cusum_n == 0.0f) {
+    float diff = x - d->media_s;
+    d->media_s += DETECTOR_ALFA * diff;
+    d->var_s2 = (1.0f - DETECTOR_ALFA) * (d->var_s2 + DETECTOR_ALFA * diff * diff);
+    d->amostras++;
+  }
+
+  d->ultima_us = agora_us;
+}
+
+// Estado no instante atual, considerando também o intervalo ainda sem lata
+detector_estado_t detector_avaliar(const detector_latas_t *d, uint64_t agora_us) {
+  float aberto = (float)(agora_us - d->ultima_us) * 1e-6f;
+
+  // Sobrevivência de um intervalo aberto: ln(S1/S0) = -(taxa1 - taxa0) t
+  float cusum_o = d->cusum_o - d->delta_o * aberto;
+
+  float desvio = sqrtf(d->var_s2);
+  bool aquecido = d->amostras >= DETECTOR_AQUECIMENTO;
+  bool gap_pre = aquecido && aberto > d->media_s + d->k_pre * desvio;
+  bool gap_parada = aquecido && aberto > d->media_s + d->k_parada * desvio;
+
+  if (cusum_o >= d->limiar_parada || gap_parada)
+    return DETECTOR_OBSTRUCAO;
+  if (d->cusum_s >= d->limiar_parada || d->cusum_n >= d->limiar_parada)
+    return DETECTOR_SOBRECARGA;
+  if (cusum_o >= d->limiar_pre || gap_pre)
+    return DETECTOR_PRE_OBSTRUCAO;
+  if (d->cusum_s >= d->limiar_pre || d->cusum_n >= d->limiar_pre)
+    return DETECTOR_PRE_SOBRECARGA;
+  return DETECTOR_NORMAL;
+}
@@ -0,0 +1,50 @@
+#ifndef DETECTOR_LATAS_H
+#define DETECTOR_LATAS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Detecção antecipada de obstrução ('O') e sobrecarga do operário ('S') a partir dos
+// intervalos entre latas, sem esperar duas janelas de 6 s.
+//  - CUSUM de razão de verossimilhança (intervalos exponenciais) para queda e para
+//    aumento da taxa; a queda também é avaliada durante o intervalo ainda aberto.
+//  - Teste do comprimento do intervalo aberto contra a distribuição observada
+//    (média e desvio-padrão por média móvel exponencial).
+//  - CUSUM dos intervalos normalizados por esse desvio contra o intervalo mínimo aceito,
+//    que reage rápido à sobrecarga quando as chegadas são regulares.
+
+typedef enum {
+  DETECTOR_NORMAL = 0,
+  DETECTOR_PRE_OBSTRUCAO,
+  DETECTOR_PRE_SOBRECARGA,
+  DETECTOR_OBSTRUCAO,
+  DETECTOR_SOBRECARGA
+} detector_estado_t;
+
+typedef struct {
+  // Faixa de taxa aceita pelo controle da esteira (latas/s)
+  float taxa_baixa, taxa_alta;
+  float intervalo_minimo_s;     // Menor intervalo fisicamente possível (espaçamento / velocidade)
+
+  // Limiares
+  float limiar_pre, limiar_parada;  // CUSUM, em log-verossimilhança
+  float k_pre, k_parada;            // Desvios-padrão além do intervalo médio
+
+  // Incrementos do CUSUM pré-calculados: ln(taxa1/taxa0) e (taxa1 - taxa0)
+  float ln_o, delta_o, ln_s, delta_s;
+  float cusum_o, cusum_s, cusum_n;
+
+  // Distribuição dos intervalos
+  float media_s, var_s2;
+  uint32_t amostras;
+
+  uint64_t ultima_us;
+} detector_latas_t;
+
+void detector_init(detector_latas_t *d, float taxa_baixa, float taxa_alta);
+void detector_reiniciar(detector_latas_t *d, uint64_t agora_us);
+void detector_ajustar_esteira(detector_latas_t *d, float espacamento, float velocidade);
+void detector_lata(detector_latas_t *d, uint64_t agora_us);
+detector_estado_t detector_avaliar(const detector_latas_t *d, uint64_t agora_us);
+
+#endif
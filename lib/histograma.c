@@ -0,0 +1,77 @@
+#include <string.h>
+#include "histograma.h"
+
+// Valores abaixo de HISTOGRAMA_SUB têm balde próprio; acima, o expoente escolhe o
+// grupo e os HISTOGRAMA_BITS_SUB bits seguintes ao mais significativo, o balde
+static inline uint32_t balde(uint32_t valor) {
+  if (valor < HISTOGRAMA_SUB)
+    return valor;
+  uint32_t expoente = 31 - __builtin_clz(valor);
+  uint32_t deslocamento = expoente - HISTOGRAMA_BITS_SUB;
+  return (deslocamento + 1) * HISTOGRAMA_SUB + (valor >> deslocamento) - HISTOGRAMA_SUB;
+}
+
+// Maior valor que cai no balde (valor equivalente mais alto)
+static uint32_t limite_superior(uint32_t indice) {
+  if (indice < HISTOGRAMA_SUB)
+    return indice;
+  uint32_t deslocamento = indice / HISTOGRAMA_SUB - 1;
+  uint64_t mantissa = indice % HISTOGRAMA_SUB + HISTOGRAMA_SUB;
+  return (uint32_t)(((mantissa + 1) << deslocamento) - 1);
+}
+
+void histograma_zerar(histograma_t *h) {
+  memset(h->contagem, 0, sizeof(h->contagem));
+  h->total = 0;
+  h->minimo = UINT32_MAX;
+  h->maximo = 0;
+}
+
+void histograma_registrar(histograma_t *h, uint32_t valor) {
+  h->contagem[balde(valor)]++;
+  h->total++;
+  if (valor < h->minimo)
+    h->minimo = valor;
+  if (valor > h->maximo)
+    h->maximo = valor;
+}
+
+// Junta um período ao acumulado: mesma grade de baldes, basta somar
+void histograma_mesclar(histograma_t *destino, const histograma_t *origem) {
+  for (uint32_t i = 0; i < HISTOGRAMA_BALDES; ++i)
+    destino->contagem[i] += origem->contagem[i];
+  destino->total += origem->total;
+  if (origem->minimo < destino->minimo)
+    destino->minimo = origem->minimo;
+  if (origem->maximo > destino->maximo)
+    destino->maximo = origem->maximo;
+}
+
+// Menor valor com pelo menos percentil% das amostras até ele (0 se vazio)
+uint32_t histograma_percentil(const histograma_t *h, float percentil) {
+  if (h->total == 0)
+    return 0;
+  uint32_t alvo = (uint32_t)(percentil / 100.0f * h->total + 0.5f);
+  if (alvo < 1)
+    alvo = 1;
+  if (alvo > h->total)
+    alvo = h->total;
+
+  uint32_t acumulado = 0;
+  for (uint32_t i = 0; i < HISTOGRAMA_BALDES; ++i) {
+    acumulado += h->contagem[i];
+    if (acumulado >= alvo) {
+      uint32_t v = limite_superior(i);
+      return v < h->maximo ? v : h->maximo;
+    }
+  }
+  return h->maximo;
+}
+
+void histograma_resumo(const histograma_t *h, histograma_resumo_t *r) {
+  r->total = h->total;
+  r->p50 = histograma_percentil(h, 50.0f);
+  r->p90 = histograma_percentil(h, 90.0f);
+  r->p99 = histograma_percentil(h, 99.0f);
+  r->maximo = h->maximo;
+}
@@ -0,0 +1,33 @@
+#ifndef HISTOGRAMA_H
+#define HISTOGRAMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Histograma log-linear (estilo HDR) de memória fixa para valores de 32 bits.
+// Cada potência de 2 é dividida em HISTOGRAMA_SUB baldes lineares, o que dá erro
+// relativo máximo de 1/HISTOGRAMA_SUB (~3%) em qualquer escala, de microssegundos a
+// horas. Registrar é O(1) e não aloca; percentis percorrem os baldes.
+
+#define HISTOGRAMA_BITS_SUB 5
+#define HISTOGRAMA_SUB (1u << HISTOGRAMA_BITS_SUB)
+#define HISTOGRAMA_BALDES ((32 - HISTOGRAMA_BITS_SUB + 1) * HISTOGRAMA_SUB)
+
+typedef struct {
+  uint32_t contagem[HISTOGRAMA_BALDES];
+  uint32_t total;
+  uint32_t minimo, maximo;
+} histograma_t;
+
+typedef struct {
+  uint32_t total;
+  uint32_t p50, p90, p99, maximo;
+} histograma_resumo_t;
+
+void histograma_zerar(histograma_t *h);
+void histograma_registrar(histograma_t *h, uint32_t valor);
+void histograma_mesclar(histograma_t *destino, const histograma_t *origem);
+uint32_t histograma_percentil(const histograma_t *h, float percentil);
+void histograma_resumo(const histograma_t *h, histograma_resumo_t *r);
+
+#endif
@@ -0,0 +1,294 @@
+#define _GNU_SOURCE  // posix_openpt/ptsname_r no transporte de teste do host
+#include <string.h>
+#include "lora_enlace.h"
+
+#if LORA_TRANSPORTE_PTY
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#define LORA_CABECALHO 3   // tipo, id da linha, sequência
+
+void lora_config_padrao(lora_config_t *cfg, uint8_t id_linha) {
+  cfg->id_linha = id_linha;
+  cfg->sf = 9;
+  cfg->bw_hz = 125000;
+  cfg->cr = 1;
+  cfg->preambulo = 8;
+  cfg->ciclo_milesimos = 10;   // 1% (sub-banda ISM típica)
+  cfg->tempo_ack_ms = 2000;
+  cfg->max_tentativas = 3;
+  cfg->intervalo_agregacao_ms = 60000; // ~10 relatórios de 6 s por pacote
+}
+
+void lora_enlace_init(lora_enlace_t *le, const lora_config_t *cfg, const lora_transporte_t *transporte) {
+  memset(le, 0, sizeof(*le));
+  le->cfg = *cfg;
+  le->transporte = *transporte;
+}
+
+// Tempo no ar de um quadro LoRa (Semtech AN1200.13), cabeçalho explícito e CRC ligado
+uint32_t lora_tempo_no_ar_us(const lora_config_t *cfg, uint8_t tam) {
+  uint32_t tsym_us = ((uint32_t)1 << cfg->sf) * 1000000u / cfg->bw_hz;
+  int de = (cfg->sf >= 11 && cfg->bw_hz <= 125000); // Otimização para taxa baixa
+  int num = 8 * tam - 4 * cfg->sf + 28 + 16;
+  int den = 4 * (cfg->sf - 2 * de);
+  uint32_t simbolos = 8;
+  if (num > 0)
+    simbolos += ((num + den - 1) / den) * (cfg->cr + 4);
+  return (cfg->preambulo * 4u + 17u) * tsym_us / 4u + simbolos * tsym_us; // (preâmbulo + 4.25) símbolos
+}
+
+// CRC-16/CCITT-FALSE do quadro na UART
+static uint16_t crc16(const uint8_t *dados, size_t n) {
+  uint16_t crc = 0xFFFF;
+  while (n--) {
+    crc ^= (uint16_t)(*dados++) << 8;
+    for (int i = 0; i < 8; ++i)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+static uint8_t escrever_varint(uint8_t *p, uint32_t v) {
+  uint8_t n = 0;
+  while (v >= 0x80) {
+    p[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  p[n++] = (uint8_t)v;
+  return n;
+}
+
+// Zigzag: diferenças pequenas, positivas ou negativas, cabem em um byte
+static uint8_t escrever_delta(uint8_t *p, int32_t v) {
+  return escrever_varint(p, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static void iniciar_pacote(lora_enlace_t *le, uint32_t agora_ms) {
+  le->montagem.dados[0] = LORA_TIPO_DADOS;
+  le->montagem.dados[1] = le->cfg.id_linha;
+  le->montagem.dados[2] = 0; // Sequência definida ao fechar
+  le->montagem.tam = LORA_CABECALHO;
+  le->montagem.tam += escrever_varint(&le->montagem.dados[LORA_CABECALHO], agora_ms / 100); // Base em décimos de segundo
+  le->montando = true;
+  le->urgente = false;
+  le->inicio_montagem_ms = agora_ms;
+  le->ultimo_registro_ms = agora_ms;
+  memset(le->ref, 0, sizeof(le->ref)); // Primeiro registro vai em valor absoluto
+}
+
+static void descartar_primeiro(lora_enlace_t *le) {
+  le->inicio = (le->inicio + 1) % LORA_FILA_TAM;
+  le->quantidade--;
+  le->aguardando_ack = false;
+  le->tentativas = 0;
+}
+
+// Fecha o pacote em montagem e o coloca na fila; se cheia, o mais antigo é perdido
+static void fechar_pacote(lora_enlace_t *le) {
+  if (!le->montando)
+    return;
+  le->montando = false;
+
+  if (le->quantidade == LORA_FILA_TAM) {
+    descartar_primeiro(le);
+    le->descartados++;
+  }
+  le->montagem.seq = le->proxima_seq++;
+  le->montagem.dados[2] = le->montagem.seq;
+  le->fila[(le->inicio + le->quantidade) % LORA_FILA_TAM] = le->montagem;
+  le->quantidade++;
+}
+
+// Anexa um registro ao pacote em montagem. Estatísticas levam só os campos que mudaram
+// desde o registro anterior (máscara nos bits 2..6 da etiqueta), em diferença zigzag.
+static void anexar(lora_enlace_t *le, uint32_t agora_ms, uint8_t tipo, const int32_t *valores, uint8_t motivo) {
+  uint8_t tmp[LORA_MTU];
+  for (int tentativa = 0; tentativa < 2; ++tentativa) {
+    if (!le->montando)
+      iniciar_pacote(le, agora_ms);
+
+    uint8_t k = 1;
+    k += escrever_varint(&tmp[k], agora_ms / 100 - le->ultimo_registro_ms / 100);
+    uint8_t mascara = 0;
+    if (valores) {
+      for (int i = 0; i < LORA_CAMPOS; ++i) {
+        if (valores[i] != le->ref[i]) {
+          mascara |= 1u << i;
+          k += escrever_delta(&tmp[k], valores[i] - le->ref[i]);
+        }
+      }
+    } else {
+      tmp[k++] = motivo;
+    }
+    tmp[0] = tipo | (uint8_t)(mascara << 2);
+
+    if (le->montagem.tam + k <= LORA_MTU) {
+      memcpy(&le->montagem.dados[le->montagem.tam], tmp, k);
+      le->montagem.tam += k;
+      le->ultimo_registro_ms = agora_ms;
+      if (valores)
+        memcpy(le->ref, valores, sizeof(le->ref));
+      return;
+    }
+    fechar_pacote(le); // Não coube: recomeça em um pacote novo, em valor absoluto
+  }
+}
+
+void lora_enlace_estatistica(lora_enlace_t *le, uint32_t agora_ms, int latas, float media, float velocidade, int umidade, char estado) {
+  int32_t valores[LORA_CAMPOS] = {
+    latas,
+    (int32_t)(media * 100.0f + 0.5f),
+    (int32_t)(velocidade * 100.0f + 0.5f),
+    umidade,
+    estado
+  };
+  anexar(le, agora_ms, LORA_REG_ESTATISTICA, valores, 0);
+}
+
+// Paradas saem no próximo ciclo da tarefa, sem esperar o intervalo de agregação
+void lora_enlace_evento(lora_enlace_t *le, uint32_t agora_ms, char motivo) {
+  anexar(le, agora_ms, LORA_REG_EVENTO, NULL, (uint8_t)motivo);
+  le->urgente = true;
+}
+
+static void transmitir(lora_enlace_t *le, uint32_t agora_ms) {
+  const lora_pacote_t *p = &le->fila[le->inicio];
+  uint8_t quadro[LORA_MTU + 4];
+  quadro[0] = LORA_SOF;
+  quadro[1] = p->tam;
+  memcpy(&quadro[2], p->dados, p->tam);
+  uint16_t crc = crc16(&quadro[1], p->tam + 1);
+  quadro[p->tam + 2] = crc >> 8;
+  quadro[p->tam + 3] = crc & 0xFF;
+  le->transporte.escrever(le->transporte.ctx, quadro, p->tam + 4);
+
+  // Respeita o ciclo de trabalho: o rádio fica calado proporcionalmente ao tempo no ar
+  uint32_t no_ar_ms = (lora_tempo_no_ar_us(&le->cfg, p->tam + 4) + 999) / 1000;
+  le->tempo_no_ar_ms += no_ar_ms;
+  le->proximo_tx_ms = agora_ms + no_ar_ms + no_ar_ms * (1000u - le->cfg.ciclo_milesimos) / le->cfg.ciclo_milesimos;
+
+  // Espera pelo ACK dobra a cada tentativa
+  le->prazo_ack_ms = agora_ms + no_ar_ms + (le->cfg.tempo_ack_ms << le->tentativas);
+  if (le->tentativas == 0)
+    le->enviados++;
+  else
+    le->retransmitidos++;
+  le->tentativas++;
+  le->aguardando_ack = true;
+}
+
+static void processar_quadro(lora_enlace_t *le, const uint8_t *dados, uint8_t tam) {
+  if (tam < LORA_CABECALHO || dados[0] != LORA_TIPO_ACK || dados[1] != le->cfg.id_linha)
+    return;
+  // Também vale depois do prazo: um ACK atrasado chega antes de o ciclo de trabalho
+  // liberar a retransmissão e poupa tempo no ar
+  if (le->quantidade > 0 && le->tentativas > 0 && dados[2] == le->fila[le->inicio].seq) {
+    descartar_primeiro(le);
+    le->confirmados++;
+  }
+}
+
+// Quadro: SOF, tamanho, carga útil, CRC-16 (MSB primeiro)
+static void receber(lora_enlace_t *le) {
+  uint8_t buf[16];
+  int n;
+  while ((n = le->transporte.ler(le->transporte.ctx, buf, sizeof(buf))) > 0) {
+    for (int i = 0; i < n; ++i) {
+      uint8_t b = buf[i];
+      if (le->rx_pos == 0) {
+        if (b == LORA_SOF)
+          le->rx_pos = 1;
+        continue;
+      }
+      le->rx[le->rx_pos - 1] = b;
+      le->rx_pos++;
+      if (le->rx_pos == 2 && (b == 0 || b > LORA_MTU)) {
+        le->rx_pos = 0; // Tamanho inválido: procura o próximo SOF
+        continue;
+      }
+      uint8_t tam = le->rx[0];
+      if (le->rx_pos - 1 == tam + 3) {
+        uint16_t crc = (uint16_t)(le->rx[tam + 1] << 8) | le->rx[tam + 2];
+        if (crc == crc16(le->rx, tam + 1))
+          processar_quadro(le, &le->rx[1], tam);
+        le->rx_pos = 0;
+      }
+    }
+  }
+}
+
+// Chamada periodicamente no laço principal; nunca bloqueia esperando o rádio
+void lora_enlace_tarefa(lora_enlace_t *le, uint32_t agora_ms) {
+  receber(le);
+
+  if (le->montando && (le->urgente || agora_ms - le->inicio_montagem_ms >= le->cfg.intervalo_agregacao_ms))
+    fechar_pacote(le);
+
+  if (le->aguardando_ack && (int32_t)(agora_ms - le->prazo_ack_ms) >= 0) {
+    le->aguardando_ack = false;
+    if (le->tentativas >= le->cfg.max_tentativas) {
+      descartar_primeiro(le);
+      le->descartados++;
+    }
+  }
+
+  if (!le->aguardando_ack && le->quantidade > 0 && (int32_t)(agora_ms - le->proximo_tx_ms) >= 0)
+    transmitir(le, agora_ms);
+}
+
+static int uart_escrever(void *ctx, const uint8_t *dados, size_t n) {
+  uart_write_blocking((uart_inst_t *)ctx, dados, n);
+  return (int)n;
+}
+
+static int uart_ler(void *ctx, uint8_t *dados, size_t max) {
+  uart_inst_t *uart = (uart_inst_t *)ctx;
+  size_t n = 0;
+  while (n < max && uart_is_readable(uart))
+    dados[n++] = (uint8_t)uart_getc(uart);
+  return (int)n;
+}
+
+void lora_transporte_uart(lora_transporte_t *t, uart_inst_t *uart) {
+  t->escrever = uart_escrever;
+  t->ler = uart_ler;
+  t->ctx = uart;
+}
+
+#if LORA_TRANSPORTE_PTY
+static int pty_escrever(void *ctx, const uint8_t *dados, size_t n) {
+  return (int)write((int)(intptr_t)ctx, dados, n);
+}
+
+static int pty_ler(void *ctx, uint8_t *dados, size_t max) {
+  ssize_t n = read((int)(intptr_t)ctx, dados, max);
+  return n > 0 ? (int)n : 0;
+}
+
+// Substitui o modem por um pseudo-terminal; o simulador do gateway abre "nome"
+int lora_transporte_pty(lora_transporte_t *t, char *nome, size_t tam_nome) {
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0)
+    return -1;
+  if (grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname_r(fd, nome, tam_nome) != 0) {
+    close(fd);
+    return -1;
+  }
+
+  struct termios tio;
+  tcgetattr(fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(fd, TCSANOW, &tio);
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  t->escrever = pty_escrever;
+  t->ler = pty_ler;
+  t->ctx = (void *)(intptr_t)fd;
+  return fd;
+}
+#endif
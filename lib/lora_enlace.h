@@ -0,0 +1,98 @@
+#ifndef LORA_ENLACE_H
+#define LORA_ENLACE_H
+
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+
+// Pseudo-terminal no lugar do modem, só na plataforma host do SDK
+#if defined(PICO_ON_DEVICE) && !PICO_ON_DEVICE
+#define LORA_TRANSPORTE_PTY 1
+#else
+#define LORA_TRANSPORTE_PTY 0
+#endif
+
+// Camada de enlace para modem LoRa em modo transparente ligado por UART.
+// Estatísticas periódicas e eventos de parada são agregados em pacotes compactos
+// (valores em delta, varint zigzag), enfileirados e enviados respeitando o ciclo de
+// trabalho do rádio, com confirmação (ACK) e retransmissão.
+
+#define LORA_MTU 51            // Maior carga útil enviada (limite de LoRaWAN em SF12/125 kHz)
+#define LORA_FILA_TAM 4        // Pacotes aguardando transmissão
+#define LORA_SOF 0x7E          // Início de quadro na UART
+#define LORA_CAMPOS 5          // latas, media*100, velocidade*100, umidade, estado
+
+typedef enum {
+  LORA_TIPO_DADOS = 0x01,
+  LORA_TIPO_ACK = 0x02
+} lora_tipo_t;
+
+typedef enum {
+  LORA_REG_ESTATISTICA = 0x01,
+  LORA_REG_EVENTO = 0x02
+} lora_registro_t;
+
+// Meio físico até o modem: a UART no dispositivo, um pseudo-terminal nos testes no host
+typedef struct {
+  int (*escrever)(void *ctx, const uint8_t *dados, size_t n);
+  int (*ler)(void *ctx, uint8_t *dados, size_t max);  // Não bloqueante
+  void *ctx;
+} lora_transporte_t;
+
+typedef struct {
+  uint8_t id_linha;             // Identifica a esteira no gateway compartilhado
+  uint8_t sf;                   // Spreading factor (7..12)
+  uint32_t bw_hz;               // Largura de banda
+  uint8_t cr;                   // Taxa de código 4/(4+cr), cr de 1 a 4
+  uint16_t preambulo;           // Símbolos de preâmbulo
+  uint16_t ciclo_milesimos;     // Ciclo de trabalho permitido (10 = 1%)
+  uint32_t tempo_ack_ms;        // Espera pelo ACK antes de retransmitir
+  uint8_t max_tentativas;       // Transmissões por pacote antes de descartá-lo
+  uint32_t intervalo_agregacao_ms; // Idade máxima de um pacote em montagem
+} lora_config_t;
+
+typedef struct {
+  uint8_t seq, tam;
+  uint8_t dados[LORA_MTU];
+} lora_pacote_t;
+
+typedef struct {
+  lora_config_t cfg;
+  lora_transporte_t transporte;
+
+  // Pacote em montagem e referência para as diferenças
+  lora_pacote_t montagem;
+  bool montando, urgente;
+  uint32_t inicio_montagem_ms, ultimo_registro_ms;
+  int32_t ref[LORA_CAMPOS];     // Último registro de estatística do pacote
+
+  // Fila circular de pacotes prontos; fila[inicio] é o que está no ar
+  lora_pacote_t fila[LORA_FILA_TAM];
+  uint8_t inicio, quantidade;
+  uint8_t proxima_seq;
+
+  bool aguardando_ack;
+  uint8_t tentativas;
+  uint32_t prazo_ack_ms, proximo_tx_ms;
+
+  // Recepção de quadros vindos do modem
+  uint8_t rx[LORA_MTU + 4];
+  uint8_t rx_pos;
+
+  // Contadores para diagnóstico
+  uint32_t enviados, retransmitidos, confirmados, descartados, tempo_no_ar_ms;
+} lora_enlace_t;
+
+void lora_config_padrao(lora_config_t *cfg, uint8_t id_linha);
+void lora_enlace_init(lora_enlace_t *le, const lora_config_t *cfg, const lora_transporte_t *transporte);
+void lora_enlace_estatistica(lora_enlace_t *le, uint32_t agora_ms, int latas, float media, float velocidade, int umidade, char estado);
+void lora_enlace_evento(lora_enlace_t *le, uint32_t agora_ms, char motivo);
+void lora_enlace_tarefa(lora_enlace_t *le, uint32_t agora_ms);
+uint32_t lora_tempo_no_ar_us(const lora_config_t *cfg, uint8_t tam);
+
+void lora_transporte_uart(lora_transporte_t *t, uart_inst_t *uart);
+#if LORA_TRANSPORTE_PTY
+int lora_transporte_pty(lora_transporte_t *t, char *nome, size_t tam_nome);
+#endif
+
+#endif
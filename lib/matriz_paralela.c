@@ -0,0 +1,91 @@
+#include "matriz_paralela.h"
+#include "hardware/dma.h"
+#include "PassaOuRepassa.pio.h"
+
+void matriz_paralela_init(matriz_paralela_t *mp, PIO pio, uint pin_base, uint n_fitas) {
+  // O plano de bits tem 8 bits: mais fitas não caberiam no quadro nem nos pinos de saída
+  if (n_fitas > MATRIZ_PARALELA_MAX_FITAS)
+    n_fitas = MATRIZ_PARALELA_MAX_FITAS;
+
+  mp->pio = pio;
+  mp->pin_base = pin_base;
+  mp->n_fitas = n_fitas;
+  mp->n_palavras = 0;
+
+  uint offset = pio_add_program(pio, &PassaOuRepassa_paralelo_program);
+  mp->sm = pio_claim_unused_sm(pio, true);
+  PassaOuRepassa_paralelo_program_init(pio, mp->sm, offset, pin_base, n_fitas);
+
+  // DMA alimenta a FIFO da state machine, no ritmo pedido pelo PIO (DREQ)
+  mp->dma_canal = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(mp->dma_canal);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, pio_get_dreq(pio, mp->sm, true));
+  dma_channel_configure(mp->dma_canal, &c, &pio->txf[mp->sm], mp->quadro, 0, false);
+}
+
+// Transpõe 8 bytes (uma cor de até 8 fitas) em 8 planos de bits.
+// Entrada: x = f7:f6:f5:f4, y = f3:f2:f1:f0 (um byte por fita).
+// Saída: bytes de x = planos 0..3, bytes de y = planos 4..7, do mais significativo ao menos.
+// O bit k de cada plano é o bit da fita k (Hacker's Delight, transpose8).
+static inline void transpor8(uint32_t *x, uint32_t *y) {
+  uint32_t t;
+  t = (*x ^ (*x >> 7)) & 0x00AA00AA; *x = *x ^ t ^ (t << 7);
+  t = (*y ^ (*y >> 7)) & 0x00AA00AA; *y = *y ^ t ^ (t << 7);
+  t = (*x ^ (*x >> 14)) & 0x0000CCCC; *x = *x ^ t ^ (t << 14);
+  t = (*y ^ (*y >> 14)) & 0x0000CCCC; *y = *y ^ t ^ (t << 14);
+  t = (*x & 0xF0F0F0F0) | ((*y >> 4) & 0x0F0F0F0F);
+  *y = ((*x << 4) & 0xF0F0F0F0) | (*y & 0x0F0F0F0F);
+  *x = t;
+}
+
+// Converte n_leds cores (formato de matrix_rgb: G<<24 | R<<16 | B<<8) de cada fita
+// em 6 palavras por LED: 24 planos de bits, o primeiro plano no byte menos significativo.
+void matriz_paralela_transpor(uint32_t *saida, const uint32_t *const fitas[], uint n_fitas, uint n_leds) {
+  if (n_fitas > MATRIZ_PARALELA_MAX_FITAS)
+    n_fitas = MATRIZ_PARALELA_MAX_FITAS;
+
+  for (uint led = 0; led < n_leds; ++led) {
+    uint32_t cor[MATRIZ_PARALELA_MAX_FITAS] = {0};
+    for (uint f = 0; f < n_fitas; ++f)
+      cor[f] = fitas[f][led];
+
+    for (int deslocamento = 24; deslocamento >= 8; deslocamento -= 8) {
+      uint32_t x = ((cor[7] >> deslocamento) & 0xFF) << 24 | ((cor[6] >> deslocamento) & 0xFF) << 16 |
+                   ((cor[5] >> deslocamento) & 0xFF) << 8 | ((cor[4] >> deslocamento) & 0xFF);
+      uint32_t y = ((cor[3] >> deslocamento) & 0xFF) << 24 | ((cor[2] >> deslocamento) & 0xFF) << 16 |
+                   ((cor[1] >> deslocamento) & 0xFF) << 8 | ((cor[0] >> deslocamento) & 0xFF);
+      transpor8(&x, &y);
+      // A PIO consome o byte menos significativo primeiro: inverte a ordem dos bytes
+      *saida++ = __builtin_bswap32(x);
+      *saida++ = __builtin_bswap32(y);
+    }
+  }
+}
+
+// Transpõe o quadro e dispara o DMA; todas as fitas são atualizadas no tempo de uma só.
+void matriz_paralela_enviar(matriz_paralela_t *mp, const uint32_t *const fitas[], uint n_leds) {
+  if (n_leds > MATRIZ_PARALELA_MAX_LEDS)
+    n_leds = MATRIZ_PARALELA_MAX_LEDS;
+
+  matriz_paralela_aguardar(mp); // Não sobrescreve um quadro ainda em transmissão
+  matriz_paralela_transpor(mp->quadro, fitas, mp->n_fitas, n_leds);
+  mp->n_palavras = n_leds * MATRIZ_PARALELA_PALAVRAS_POR_LED;
+  dma_channel_transfer_from_buffer_now(mp->dma_canal, mp->quadro, mp->n_palavras);
+}
+
+// Espera o quadro em andamento sair por completo e mantém o reset das fitas antes do próximo
+void matriz_paralela_aguardar(matriz_paralela_t *mp) {
+  if (mp->n_palavras == 0)
+    return; // Nenhum quadro enviado desde a última espera
+
+  dma_channel_wait_for_finish_blocking(mp->dma_canal);
+  // O DMA termina com até 8 palavras ainda na FIFO da PIO
+  while (!pio_sm_is_tx_fifo_empty(mp->pio, mp->sm))
+    tight_loop_contents();
+  // A última palavra ainda está no OSR (< 6 us); o reset em nível baixo cobre essa folga
+  sleep_us(MATRIZ_PARALELA_RESET_US);
+  mp->n_palavras = 0;
+}
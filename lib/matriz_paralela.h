@@ -0,0 +1,27 @@
+#ifndef MATRIZ_PARALELA_H
+#define MATRIZ_PARALELA_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#define MATRIZ_PARALELA_MAX_FITAS 8   // Uma fita por bit do plano (mov pins, x)
+#define MATRIZ_PARALELA_MAX_LEDS 25   // LEDs por fita (matriz 5x5)
+#define MATRIZ_PARALELA_PALAVRAS_POR_LED 6  // 24 planos de bits / 4 planos por palavra
+#define MATRIZ_PARALELA_RESET_US 300  // Linha em nível baixo entre quadros (WS2812B: >= 280 us)
+
+typedef struct {
+  PIO pio;
+  uint sm;
+  uint pin_base, n_fitas;
+  int dma_canal;
+  // Quadro já transposto, no formato consumido pelo programa PassaOuRepassa_paralelo
+  uint32_t quadro[MATRIZ_PARALELA_MAX_LEDS * MATRIZ_PARALELA_PALAVRAS_POR_LED];
+  uint n_palavras;
+} matriz_paralela_t;
+
+void matriz_paralela_init(matriz_paralela_t *mp, PIO pio, uint pin_base, uint n_fitas);
+void matriz_paralela_transpor(uint32_t *saida, const uint32_t *const fitas[], uint n_fitas, uint n_leds);
+void matriz_paralela_enviar(matriz_paralela_t *mp, const uint32_t *const fitas[], uint n_leds);
+void matriz_paralela_aguardar(matriz_paralela_t *mp);
+
+#endif
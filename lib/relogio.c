@@ -0,0 +1,144 @@
+#include "relogio.h"
+#include "hardware/clocks.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+
+typedef enum {
+  RELOGIO_GENERICO,
+  RELOGIO_PIO,
+  RELOGIO_PWM,
+  RELOGIO_I2C,
+  RELOGIO_UART
+} relogio_tipo_t;
+
+typedef struct {
+  relogio_tipo_t tipo;
+  void *periferico;             // PIO, i2c_inst_t ou uart_inst_t
+  uint indice;                  // State machine ou slice de PWM
+  uint32_t freq_hz;             // Frequência desejada, independente de clk_sys
+  relogio_preparo_t preparo;
+  relogio_ajuste_t ajuste;
+  void *ctx;
+} relogio_periferico_t;
+
+static relogio_periferico_t perifericos[RELOGIO_MAX_PERIFERICOS];
+static uint n_perifericos;
+
+static uint32_t khz_ativo, khz_ocioso, espera_ocioso_ms;
+static uint32_t ultima_atividade_ms;
+
+static void aplicar(const relogio_periferico_t *p, uint32_t clk_sys_hz) {
+  switch (p->tipo) {
+  case RELOGIO_PIO:
+    pio_sm_set_clkdiv((PIO)p->periferico, p->indice, (float)clk_sys_hz / p->freq_hz);
+    break;
+  case RELOGIO_PWM:
+    pwm_set_clkdiv(p->indice, (float)clk_sys_hz / p->freq_hz);
+    break;
+  case RELOGIO_I2C:
+    i2c_set_baudrate((i2c_inst_t *)p->periferico, p->freq_hz); // A temporização do I2C deriva de clk_sys
+    break;
+  case RELOGIO_UART:
+    uart_set_baudrate((uart_inst_t *)p->periferico, p->freq_hz);
+    break;
+  case RELOGIO_GENERICO:
+    if (p->ajuste)
+      p->ajuste(clk_sys_hz, p->ctx);
+    break;
+  }
+}
+
+// Não troca o clock com bytes ainda saindo: eles seriam transmitidos na taxa errada.
+// Roda com as interrupções inibidas, por isso espera ativa em vez de sleep_us.
+static void esvaziar(const relogio_periferico_t *p) {
+  if (p->tipo == RELOGIO_UART) {
+    uart_tx_wait_blocking((uart_inst_t *)p->periferico);
+  } else if (p->tipo == RELOGIO_PIO) {
+    while (!pio_sm_is_tx_fifo_empty((PIO)p->periferico, p->indice))
+      tight_loop_contents();
+    busy_wait_us(300); // Último dado no registrador de deslocamento e reset dos LEDs (WS2812B: >= 280 us)
+  }
+}
+
+bool relogio_definir_khz(uint32_t khz) {
+  if (clock_get_hz(clk_sys) == khz * 1000u)
+    return true;
+
+  // Preparos genéricos (ex.: pausar o barramento I2C) dependem das próprias interrupções
+  // para terminar o que está em curso: rodam antes de inibi-las
+  for (uint i = 0; i < n_perifericos; ++i)
+    if (perifericos[i].tipo == RELOGIO_GENERICO && perifericos[i].preparo)
+      perifericos[i].preparo(perifericos[i].ctx);
+
+  // Daqui até os divisores novos nenhuma interrupção pode usar UART ou PIO: um printf
+  // ou quadro de LEDs sairia com o divisor antigo sobre o clock novo
+  uint32_t irq = save_and_disable_interrupts();
+  for (uint i = 0; i < n_perifericos; ++i)
+    esvaziar(&perifericos[i]);
+
+  bool ok = set_sys_clock_khz(khz, false);
+  uint32_t clk_sys_hz = clock_get_hz(clk_sys);
+  for (uint i = 0; i < n_perifericos; ++i)
+    if (perifericos[i].tipo != RELOGIO_GENERICO)
+      aplicar(&perifericos[i], clk_sys_hz);
+  restore_interrupts(irq);
+
+  // Ajustes genéricos retomam o que foi pausado, mesmo se a troca falhou
+  for (uint i = 0; i < n_perifericos; ++i)
+    if (perifericos[i].tipo == RELOGIO_GENERICO)
+      aplicar(&perifericos[i], clk_sys_hz);
+  return ok;
+}
+
+uint32_t relogio_atual_khz(void) {
+  return clock_get_hz(clk_sys) / 1000u;
+}
+
+static bool registrar(relogio_periferico_t p) {
+  if (n_perifericos == RELOGIO_MAX_PERIFERICOS)
+    return false;
+  perifericos[n_perifericos++] = p;
+  aplicar(&p, clock_get_hz(clk_sys));
+  return true;
+}
+
+bool relogio_registrar(relogio_preparo_t preparo, relogio_ajuste_t ajuste, void *ctx) {
+  return registrar((relogio_periferico_t){ .tipo = RELOGIO_GENERICO, .preparo = preparo, .ajuste = ajuste, .ctx = ctx });
+}
+
+bool relogio_registrar_pio(PIO pio, uint sm, uint32_t freq_hz) {
+  return registrar((relogio_periferico_t){ .tipo = RELOGIO_PIO, .periferico = pio, .indice = sm, .freq_hz = freq_hz });
+}
+
+bool relogio_registrar_pwm(uint slice, uint32_t freq_contagem_hz) {
+  return registrar((relogio_periferico_t){ .tipo = RELOGIO_PWM, .indice = slice, .freq_hz = freq_contagem_hz });
+}
+
+bool relogio_registrar_i2c(i2c_inst_t *i2c, uint baud) {
+  return registrar((relogio_periferico_t){ .tipo = RELOGIO_I2C, .periferico = i2c, .freq_hz = baud });
+}
+
+bool relogio_registrar_uart(uart_inst_t *uart, uint baud) {
+  return registrar((relogio_periferico_t){ .tipo = RELOGIO_UART, .periferico = uart, .freq_hz = baud });
+}
+
+void relogio_ocioso_config(uint32_t ativo_khz, uint32_t ocioso_khz, uint32_t espera_ms) {
+  khz_ativo = ativo_khz;
+  khz_ocioso = ocioso_khz;
+  espera_ocioso_ms = espera_ms;
+}
+
+// Qualquer atividade devolve o clock cheio imediatamente
+void relogio_atividade(uint32_t agora_ms) {
+  ultima_atividade_ms = agora_ms;
+  if (khz_ativo && relogio_atual_khz() != khz_ativo)
+    relogio_definir_khz(khz_ativo);
+}
+
+// Sem atividade por espera_ocioso_ms, reduz o clock
+void relogio_tarefa(uint32_t agora_ms) {
+  if (!khz_ocioso || relogio_atual_khz() == khz_ocioso)
+    return;
+  if (agora_ms - ultima_atividade_ms >= espera_ocioso_ms)
+    relogio_definir_khz(khz_ocioso);
+}
@@ -0,0 +1,33 @@
+#ifndef RELOGIO_H
+#define RELOGIO_H
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/i2c.h"
+#include "hardware/uart.h"
+
+// Gerência do clock do sistema. Cada periférico cujo divisor depende de clk_sys é
+// registrado uma vez com a frequência que precisa; a cada mudança de clock todos os
+// divisores são recalculados. Com a esteira parada o clock cai para o valor ocioso
+// e volta ao valor ativo na primeira atividade.
+
+#define RELOGIO_MAX_PERIFERICOS 8
+
+typedef void (*relogio_preparo_t)(void *ctx);  // Antes da troca: termina o que está em curso
+typedef void (*relogio_ajuste_t)(uint32_t clk_sys_hz, void *ctx);
+
+bool relogio_definir_khz(uint32_t khz);
+uint32_t relogio_atual_khz(void);
+
+// Registram e já aplicam o divisor para o clock atual
+bool relogio_registrar(relogio_preparo_t preparo, relogio_ajuste_t ajuste, void *ctx);
+bool relogio_registrar_pio(PIO pio, uint sm, uint32_t freq_hz);
+bool relogio_registrar_pwm(uint slice, uint32_t freq_contagem_hz);
+bool relogio_registrar_i2c(i2c_inst_t *i2c, uint baud);
+bool relogio_registrar_uart(uart_inst_t *uart, uint baud);
+
+void relogio_ocioso_config(uint32_t khz_ativo, uint32_t khz_ocioso, uint32_t espera_ms);
+void relogio_atividade(uint32_t agora_ms);
+void relogio_tarefa(uint32_t agora_ms);
+
+#endif
@@ -0,0 +1,63 @@
+// Interface C do ssd1306.h implementada sobre o template de lib/ssd1306.hpp.
+// Só a geometria WIDTH x HEIGHT é suportada; cada display ocupa uma das telas estáticas.
+#include "ssd1306.hpp"
+
+#ifndef SSD1306_MAX_TELAS
+#define SSD1306_MAX_TELAS 2
+#endif
+
+namespace {
+
+using Tela = Ssd1306<WIDTH, HEIGHT>;
+
+Tela telas[SSD1306_MAX_TELAS];
+uint8_t n_telas;
+
+// O ram_buffer do ssd1306_t aponta para o buffer da tela que o atende, no mesmo
+// deslocamento em cada elemento de telas: a distância ao primeiro buffer dá o índice
+inline Tela &tela(const ssd1306_t *ssd) {
+  return telas[(size_t)(ssd->ram_buffer - telas[0].buffer()) / sizeof(Tela)];
+}
+
+} // namespace
+
+extern "C" {
+
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+  if (width != Tela::width || height != Tela::height || n_telas == SSD1306_MAX_TELAS)
+    panic("ssd1306: geometria nao suportada ou telas esgotadas");
+
+  Tela &t = telas[n_telas++];
+  t.init(address, i2c);
+  ssd->width = width;
+  ssd->height = height;
+  ssd->pages = Tela::pages;
+  ssd->address = address;
+  ssd->i2c_port = i2c;
+  ssd->external_vcc = external_vcc;
+  ssd->bufsize = Tela::bufsize;
+  ssd->ram_buffer = t.buffer();
+  ssd->port_buffer[0] = 0x80;
+}
+
+void ssd1306_config(ssd1306_t *ssd) { tela(ssd).config(); }
+void ssd1306_command(ssd1306_t *ssd, uint8_t command) { tela(ssd).command(command); }
+void ssd1306_send_data(ssd1306_t *ssd) { tela(ssd).send_data(); }
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) { tela(ssd).pixel(x, y, value); }
+void ssd1306_fill(ssd1306_t *ssd, bool value) { tela(ssd).fill(value); }
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  tela(ssd).rect(top, left, width, height, value, fill);
+}
+
+void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+  tela(ssd).line(x0, y0, x1, y1, value);
+}
+
+void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) { tela(ssd).hline(x0, x1, y, value); }
+void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) { tela(ssd).vline(x, y0, y1, value); }
+void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y) { tela(ssd).draw_char(c, x, y); }
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) { tela(ssd).draw_string(str, x, y); }
+
+} // extern "C"
@@ -0,0 +1,219 @@
+#ifndef SSD1306_HPP
+#define SSD1306_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "ssd1306.h"
+#include "font.h"
+
+// Driver SSD1306 especializado em tempo de compilação. Largura, altura e orientação
+// são parâmetros do template: o buffer é estático (sem calloc) e toda a aritmética de
+// índice vira constante. O buffer segue o modo de endereçamento vertical do
+// ssd1306_config: um byte por coluna e página, precedido do byte de controle 0x40.
+
+enum class Ssd1306Orientation { Normal, Rotated180 };
+
+template <uint8_t Width, uint8_t Height, Ssd1306Orientation Orientation = Ssd1306Orientation::Normal>
+class Ssd1306 {
+  static_assert(Height % 8 == 0, "A altura precisa ser múltipla de 8 (uma página)");
+
+public:
+  static constexpr uint8_t width = Width;
+  static constexpr uint8_t height = Height;
+  static constexpr uint8_t pages = Height / 8;
+  static constexpr size_t bufsize = pages * Width + 1;
+
+  static constexpr uint16_t byte_index(uint8_t x, uint8_t y) { return x * pages + (y >> 3) + 1; }
+  static constexpr bool inside(int x, int y) { return x >= 0 && x < Width && y >= 0 && y < Height; }
+
+  // Bits y0..y1 (inclusive) de uma mesma página
+  static constexpr uint8_t page_mask(uint8_t y0, uint8_t y1) {
+    return (uint8_t)((0xFFu << (y0 & 7)) & (0xFFu >> (7 - (y1 & 7))));
+  }
+
+  static constexpr uint16_t glyph_index(char c) {
+    if (c == '.') return 1 * 8;
+    if (c == ':') return 2 * 8;
+    if (c == '%') return 3 * 8;
+    if (c == '*') return 4 * 8;
+    if (c >= '0' && c <= '9') return (c - '0' + 5) * 8;
+    if (c >= 'A' && c <= 'Z') return (c - 'A' + 15) * 8;
+    if (c >= 'a' && c <= 'z') return (c - 'a' + 41) * 8;
+    return 0;
+  }
+
+  void init(uint8_t address, i2c_inst_t *i2c) {
+    address_ = address;
+    i2c_ = i2c;
+    buffer_.fill(0);
+    buffer_[0] = 0x40;
+  }
+
+  void config() {
+    constexpr bool normal = Orientation == Ssd1306Orientation::Normal;
+    static constexpr uint8_t commands[] = {
+      SET_DISP | 0x00,
+      SET_MEM_ADDR, 0x01,
+      SET_DISP_START_LINE | 0x00,
+      SET_SEG_REMAP | (normal ? 0x01 : 0x00),
+      SET_MUX_RATIO, Height - 1,
+      SET_COM_OUT_DIR | (normal ? 0x08 : 0x00),
+      SET_DISP_OFFSET, 0x00,
+      SET_COM_PIN_CFG, Height == 64 ? 0x12 : 0x02,
+      SET_DISP_CLK_DIV, 0x80,
+      SET_PRECHARGE, 0xF1,
+      SET_VCOM_DESEL, 0x30,
+      SET_CONTRAST, 0xFF,
+      SET_ENTIRE_ON,
+      SET_NORM_INV,
+      SET_CHARGE_PUMP, 0x14,
+      SET_DISP | 0x01
+    };
+    for (uint8_t c : commands)
+      command(c);
+  }
+
+  void command(uint8_t command) {
+    uint8_t port[2] = {0x80, command};
+    i2c_write_blocking(i2c_, address_, port, 2, false);
+  }
+
+  // Janela de endereçamento em uma única transação (byte de controle 0x00) e depois o quadro
+  void send_data() {
+    static constexpr uint8_t window[] = {0x00, SET_COL_ADDR, 0, Width - 1, SET_PAGE_ADDR, 0, pages - 1};
+    i2c_write_blocking(i2c_, address_, window, sizeof(window), false);
+    i2c_write_blocking(i2c_, address_, buffer_.data(), bufsize, false);
+  }
+
+  void pixel(uint8_t x, uint8_t y, bool value) {
+    if (!inside(x, y))
+      return;
+    uint8_t bit = 1u << (y & 7);
+    if (value)
+      buffer_[byte_index(x, y)] |= bit;
+    else
+      buffer_[byte_index(x, y)] &= ~bit;
+  }
+
+  void fill(bool value) {
+    std::memset(&buffer_[1], value ? 0xFF : 0x00, bufsize - 1);
+  }
+
+  void hline(uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+    if (y >= Height || x0 > x1 || x0 >= Width)
+      return;
+    if (x1 >= Width)
+      x1 = Width - 1;
+    // Pixels vizinhos na horizontal ficam a uma página (pages bytes) de distância
+    const uint8_t bit = 1u << (y & 7);
+    uint8_t *p = &buffer_[byte_index(x0, y)];
+    uint8_t *end = &buffer_[byte_index(x1, y)];
+    if (value)
+      for (; p <= end; p += pages)
+        *p |= bit;
+    else
+      for (; p <= end; p += pages)
+        *p &= ~bit;
+  }
+
+  // Uma coluna inteira é contígua no buffer: a linha vertical escreve por página
+  void vline(uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+    if (x >= Width || y0 > y1 || y0 >= Height)
+      return;
+    if (y1 >= Height)
+      y1 = Height - 1;
+    uint8_t *col = &buffer_[byte_index(x, 0)];
+    for (uint8_t page = y0 >> 3; page <= (y1 >> 3); ++page) {
+      uint8_t first = page == (y0 >> 3) ? y0 : page * 8;
+      uint8_t last = page == (y1 >> 3) ? y1 : page * 8 + 7;
+      uint8_t mask = page_mask(first, last);
+      if (value)
+        col[page] |= mask;
+      else
+        col[page] &= ~mask;
+    }
+  }
+
+  void rect(uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+    if (width == 0 || height == 0)
+      return;
+    uint8_t right = left + width - 1, bottom = top + height - 1;
+    hline(left, right, top, value);
+    hline(left, right, bottom, value);
+    vline(left, top, bottom, value);
+    vline(right, top, bottom, value);
+    if (fill && width > 2 && height > 2) {
+      for (unsigned x = left + 1; x < right; ++x)
+        vline(x, top + 1, bottom - 1, value);
+    }
+  }
+
+  void line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    int dx = std::abs(x1 - x0);
+    int dy = std::abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx - dy;
+
+    while (true) {
+      pixel(x0, y0, value);
+      if (x0 == x1 && y0 == y1)
+        break;
+      int e2 = err * 2;
+      if (e2 > -dy) {
+        err -= dy;
+        x0 += sx;
+      }
+      if (e2 < dx) {
+        err += dx;
+        y0 += sy;
+      }
+    }
+  }
+
+  // Cada byte da fonte é uma coluna de 8 pixels: alinhado à página vira uma cópia direta,
+  // senão é dividido entre duas páginas
+  void draw_char(char c, uint8_t x, uint8_t y) {
+    if (c == ' ' || y >= Height)
+      return;
+    const uint16_t glyph = glyph_index(c);
+    const uint8_t shift = y & 7;
+    const uint8_t page = y >> 3;
+
+    for (unsigned i = 0; i < 8 && x + i < Width; ++i) {
+      uint8_t *col = &buffer_[byte_index(x + i, 0)];
+      if (shift == 0) {
+        col[page] = font[glyph + i];
+      } else {
+        col[page] = (col[page] & ~(0xFF << shift)) | (font[glyph + i] << shift);
+        if (page + 1 < pages)
+          col[page + 1] = (col[page + 1] & ~(0xFF >> (8 - shift))) | (font[glyph + i] >> (8 - shift));
+      }
+    }
+  }
+
+  void draw_string(const char *str, uint8_t x, uint8_t y) {
+    while (*str) {
+      draw_char(*str++, x, y);
+      x += 8;
+      if (x + 8 >= Width) {
+        x = 0;
+        y += 8;
+      }
+      if (y + 8 >= Height)
+        break;
+    }
+  }
+
+  uint8_t *buffer() { return buffer_.data(); }
+
+private:
+  std::array<uint8_t, bufsize> buffer_{};
+  i2c_inst_t *i2c_ = nullptr;
+  uint8_t address_ = 0;
+};
+
+#endif
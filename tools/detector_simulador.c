@@ -0,0 +1,192 @@
+// Simulador de tráfego para lib/detector_latas.c, comparado com a regra de duas janelas
+// de 6 s do laço principal. Roda no host, sem o Pico SDK.
+//
+// Para cada perfil de chegada (Poisson ou regular com coeficiente de variação CV) mede:
+//  - paradas falsas por hora com a taxa nominal (0.375 latas/s, meio da faixa 0.25..0.5);
+//  - atraso médio até a parada por obstrução (chegadas cessam) e até o alerta de
+//    sobrecarga (a taxa sobe para 1 lata/s), a partir do instante da mudança.
+// Como no firmware, só a obstrução do detector para a esteira (a sobrecarga é alerta),
+// a troca de velocidade só ajusta o intervalo mínimo e uma parada reinicia o detector.
+// Ao mudar limiar_*, k_* ou DETECTOR_FOLGA, rode de novo e atualize a tabela do README.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "detector_latas.h"
+
+#define TAXA_NOMINAL 0.375     // latas/s
+#define TAXA_SOBRECARGA 1.0    // latas/s
+#define ESPACAMENTO 0.085f     // Mesmo espaçamento entre latas do firmware (m)
+#define VELOCIDADE_N 5.6f      // Velocidades da esteira por estado (m/s)
+#define VELOCIDADE_A 6.16f
+#define VELOCIDADE_B 5.04f
+#define JANELA_S 6.0           // INTERVALO_AMOSTRAGEM
+#define PASSO_S 0.1            // Período de avaliação do laço principal
+#define HORAS_NOMINAL 200.0    // Tempo simulado para as paradas falsas
+#define REPETICOES 2000        // Eventos simulados por tipo de falha
+#define LIMITE_S 300.0         // Atraso atribuído a um evento não detectado
+#define PI 3.14159265358979323846
+
+static uint64_t semente = 42;
+
+// xorshift64*: mesma sequência em qualquer plataforma
+static double uniforme(void) {
+  semente ^= semente >> 12;
+  semente ^= semente << 25;
+  semente ^= semente >> 27;
+  return ((semente * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0) + 1e-12;
+}
+
+static double normal(void) {
+  return sqrt(-2.0 * log(uniforme())) * cos(2.0 * PI * uniforme());
+}
+
+// Próximo intervalo: exponencial (cv < 0) ou regular com dispersão cv, nunca abaixo de 0.2 s
+static double intervalo(double taxa, double cv) {
+  if (cv < 0.0)
+    return -log(uniforme()) / taxa;
+  double x = (1.0 + cv * normal()) / taxa;
+  return x < 0.2 ? 0.2 : x;
+}
+
+// Regra das duas janelas, como em main(): primeira janela fora da faixa troca a velocidade,
+// a segunda seguida para a esteira
+typedef struct {
+  char estado;
+  int latas;
+  double fim;
+} janelas_t;
+
+static char janela(janelas_t *j, detector_latas_t *d) {
+  double media = j->latas / JANELA_S;
+  char anterior = j->estado, parada = 0;
+  j->latas = 0;
+  j->fim += JANELA_S;
+  if (media < 0.25) {
+    if (j->estado == 'A')
+      parada = 'O';
+    j->estado = 'A';
+  } else if (media > 0.5) {
+    if (j->estado == 'B')
+      parada = 'S';
+    j->estado = 'B';
+  } else {
+    j->estado = 'N';
+  }
+  if (j->estado != anterior) {
+    float v = j->estado == 'A' ? VELOCIDADE_A : j->estado == 'B' ? VELOCIDADE_B : VELOCIDADE_N;
+    detector_ajustar_esteira(d, ESPACAMENTO, v);
+  }
+  return parada;
+}
+
+static void iniciar(detector_latas_t *d, janelas_t *j) {
+  detector_init(d, 0.25f, 0.5f);
+  detector_ajustar_esteira(d, ESPACAMENTO, VELOCIDADE_N);
+  detector_reiniciar(d, 0);
+  j->estado = 'N';
+  j->latas = 0;
+  j->fim = JANELA_S;
+}
+
+static bool parada(detector_estado_t e) {
+  return e == DETECTOR_OBSTRUCAO;
+}
+
+static uint64_t us(double t) {
+  return (uint64_t)(t * 1e6);
+}
+
+// Paradas falsas e alertas (pré-alarmes e sobrecarga) por hora com a taxa nominal
+static void falsos_alarmes(double cv, double *det_h, double *pre_h, double *jan_h) {
+  detector_latas_t d;
+  janelas_t j;
+  iniciar(&d, &j);
+  long paradas = 0, pre = 0, paradas_jan = 0;
+  bool pre_ativo = false;
+  double proxima = intervalo(TAXA_NOMINAL, cv);
+  for (double t = 0.0; t < HORAS_NOMINAL * 3600.0; t += PASSO_S) {
+    for (; proxima <= t; proxima += intervalo(TAXA_NOMINAL, cv)) {
+      detector_lata(&d, us(proxima));
+      j.latas++;
+    }
+    if (t >= j.fim && janela(&j, &d)) {
+      paradas_jan++;
+      j.estado = 'N';
+    }
+    detector_estado_t e = detector_avaliar(&d, us(t));
+    if (parada(e)) {
+      paradas++;
+      detector_reiniciar(&d, us(t));
+      pre_ativo = false;
+    } else if (e != DETECTOR_NORMAL) {
+      pre += !pre_ativo;
+      pre_ativo = true;
+    } else {
+      pre_ativo = false;
+    }
+  }
+  *det_h = paradas / HORAS_NOMINAL;
+  *pre_h = pre / HORAS_NOMINAL;
+  *jan_h = paradas_jan / HORAS_NOMINAL;
+}
+
+// Atraso médio até a parada por obstrução ou o alerta de sobrecarga após a falha;
+// falhas não detectadas contam LIMITE_S
+static void latencia(double cv, bool obstrucao, double *det_s, double *jan_s) {
+  double soma = 0.0, soma_jan = 0.0;
+  for (int r = 0; r < REPETICOES; ++r) {
+    detector_latas_t d;
+    janelas_t j;
+    iniciar(&d, &j);
+    double falha = 120.0 + JANELA_S * uniforme(); // Fase aleatória em relação às janelas
+    double proxima = intervalo(TAXA_NOMINAL, cv);
+    double det = -1.0, det_jan = -1.0;
+    for (double t = 0.0; t < falha + LIMITE_S && (det < 0.0 || det_jan < 0.0); t += PASSO_S) {
+      while (proxima <= t) {
+        if (obstrucao && proxima >= falha) {
+          proxima = INFINITY; // Nenhuma lata passa depois da obstrução
+          break;
+        }
+        detector_lata(&d, us(proxima));
+        j.latas++;
+        proxima += intervalo(proxima < falha ? TAXA_NOMINAL : TAXA_SOBRECARGA, cv);
+      }
+      // Depois da parada pelas janelas a esteira não troca mais de velocidade
+      if (t >= j.fim && det_jan < 0.0) {
+        char p = janela(&j, &d);
+        if (p && t >= falha && det_jan < 0.0 && p == (obstrucao ? 'O' : 'S'))
+          det_jan = t - falha;
+        else if (p)
+          j.estado = 'N';
+      }
+      detector_estado_t e = detector_avaliar(&d, us(t));
+      if (e == (obstrucao ? DETECTOR_OBSTRUCAO : DETECTOR_SOBRECARGA) && t >= falha && det < 0.0)
+        det = t - falha;
+      else if (parada(e) && t < falha)
+        detector_reiniciar(&d, us(t));
+    }
+    soma += det < 0.0 ? LIMITE_S : det;
+    soma_jan += det_jan < 0.0 ? LIMITE_S : det_jan;
+  }
+  *det_s = soma / REPETICOES;
+  *jan_s = soma_jan / REPETICOES;
+}
+
+int main(void) {
+  static const struct {
+    const char *nome;
+    double cv;
+  } perfis[] = {{"Poisson", -1.0}, {"Regular, CV 0.2", 0.2}, {"Regular, CV 0.5", 0.5}};
+
+  puts("| Chegadas | Obstrução (detector / janelas) | Sobrecarga (alerta do detector / parada das janelas) | Paradas falsas/h (detector / janelas) | Alertas/h |");
+  puts("|---|---|---|---|---|");
+  for (size_t i = 0; i < sizeof(perfis) / sizeof(perfis[0]); ++i) {
+    double lo, lo_j, ls, ls_j, fa, pre, fa_j;
+    latencia(perfis[i].cv, true, &lo, &lo_j);
+    latencia(perfis[i].cv, false, &ls, &ls_j);
+    falsos_alarmes(perfis[i].cv, &fa, &pre, &fa_j);
+    printf("| %s | %.1f s / %.1f s | %.1f s / %.1f s | %.2f / %.2f | %.1f |\n", perfis[i].nome, lo, lo_j, ls, ls_j, fa, fa_j, pre);
+  }
+  return 0;
+}
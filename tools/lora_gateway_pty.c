@@ -0,0 +1,144 @@
+// Teste da camada de enlace LoRa no host (plataforma host do Pico SDK).
+// O modem é substituído por um pseudo-terminal (lora_transporte_pty) e um processo
+// filho faz o papel do gateway: valida os quadros e devolve o ACK. Parte dos ACKs é
+// perdida ou atrasada de propósito para exercitar a retransmissão e o ACK tardio.
+//
+// O enlace roda em tempo simulado: cada volta do laço avança TEMPO_PASSO_MS e dorme
+// 1 ms real, de modo que um atraso de 100 ms no gateway equivale a vários segundos no ar.
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include "lora_enlace.h"
+
+#define TEMPO_PASSO_MS 100            // Tempo simulado por volta do laço
+#define TEMPO_SIMULADO_MS (30 * 60000u) // 30 min de relatórios de 6 s
+#define TEMPO_ESCOAR_MS (10 * 60000u)   // Prazo extra para esvaziar a fila
+#define GATEWAY_PERDE_A_CADA 5        // Um ACK perdido a cada N quadros
+#define GATEWAY_ATRASA_A_CADA 3       // Um ACK atrasado a cada N quadros
+#define GATEWAY_ATRASO_US 100000      // Passa do prazo do ACK, mas não do ciclo de trabalho
+
+static uint16_t crc16(const uint8_t *dados, size_t n) {
+  uint16_t crc = 0xFFFF;
+  while (n--) {
+    crc ^= (uint16_t)(*dados++) << 8;
+    for (int i = 0; i < 8; ++i)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+static void gateway_ack(int fd, uint8_t id_linha, uint8_t seq) {
+  uint8_t q[7] = {LORA_SOF, 3, LORA_TIPO_ACK, id_linha, seq};
+  uint16_t crc = crc16(&q[1], 4);
+  q[5] = crc >> 8;
+  q[6] = crc & 0xFF;
+  write(fd, q, sizeof(q));
+}
+
+// Processo do gateway: lê quadros até o outro lado do pseudo-terminal fechar
+static int gateway(int fd) {
+  struct termios tio;
+  tcgetattr(fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(fd, TCSANOW, &tio);
+
+  uint8_t q[LORA_MTU + 4];
+  uint32_t quadros = 0, invalidos = 0, duplicados = 0, bytes = 0;
+  int ultima_seq = -1;
+  size_t pos = 0;
+  uint8_t b;
+  while (read(fd, &b, 1) == 1) {
+    if (pos == 0 && b != LORA_SOF)
+      continue;
+    q[pos++] = b;
+    if (pos == 2 && (b == 0 || b > LORA_MTU)) {
+      pos = 0;
+      invalidos++;
+      continue;
+    }
+    if (pos < 2 || pos < (size_t)q[1] + 4)
+      continue;
+
+    uint8_t tam = q[1];
+    pos = 0;
+    if (crc16(&q[1], tam + 1) != ((uint16_t)(q[tam + 2] << 8) | q[tam + 3]) || q[2] != LORA_TIPO_DADOS) {
+      invalidos++;
+      continue;
+    }
+    quadros++;
+    bytes += tam + 4;
+    if (q[4] == ultima_seq)
+      duplicados++;
+    ultima_seq = q[4];
+
+    if (quadros % GATEWAY_PERDE_A_CADA == 0)
+      continue;
+    if (quadros % GATEWAY_ATRASA_A_CADA == 0)
+      usleep(GATEWAY_ATRASO_US);
+    gateway_ack(fd, q[3], q[4]);
+  }
+
+  printf("gateway: quadros=%u bytes=%u duplicados=%u invalidos=%u\n", quadros, bytes, duplicados, invalidos);
+  return invalidos != 0;
+}
+
+int main(void) {
+  lora_transporte_t transporte;
+  char nome[64];
+  int fd = lora_transporte_pty(&transporte, nome, sizeof(nome));
+  if (fd < 0) {
+    perror("lora_transporte_pty");
+    return 1;
+  }
+  // Abre o escravo antes do fork: o gateway já está ligado quando o primeiro quadro sai
+  int escravo = open(nome, O_RDWR | O_NOCTTY);
+  if (escravo < 0) {
+    perror(nome);
+    return 1;
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fd);
+    return gateway(escravo);
+  }
+  close(escravo);
+
+  lora_config_t cfg;
+  lora_config_padrao(&cfg, 1);
+  lora_enlace_t lora;
+  lora_enlace_init(&lora, &cfg, &transporte);
+
+  uint32_t agora_ms = 0;
+  for (; agora_ms < TEMPO_SIMULADO_MS + TEMPO_ESCOAR_MS; agora_ms += TEMPO_PASSO_MS) {
+    if (agora_ms < TEMPO_SIMULADO_MS) {
+      uint32_t janela = agora_ms / 6000;
+      if (agora_ms % 6000 == 0)
+        lora_enlace_estatistica(&lora, agora_ms, 2 + janela % 3, 0.33f + (janela % 2) * 0.01f, 5.6f, 50 + janela % 4, 'N');
+      if (agora_ms % 300000 == 150000)
+        lora_enlace_evento(&lora, agora_ms, 'O');
+    } else if (lora.quantidade == 0 && !lora.montando) {
+      break;
+    }
+    lora_enlace_tarefa(&lora, agora_ms);
+    usleep(1000);
+  }
+
+  usleep(2 * GATEWAY_ATRASO_US);
+  close(fd);
+  int status = 1;
+  waitpid(pid, &status, 0);
+
+  printf("enlace: enviados=%u retransmitidos=%u confirmados=%u descartados=%u tempo_no_ar=%u ms pendentes=%u\n",
+         lora.enviados, lora.retransmitidos, lora.confirmados, lora.descartados, lora.tempo_no_ar_ms, lora.quantidade);
+  printf("ciclo de trabalho: %.2f%% em %u s simulados\n", 100.0 * lora.tempo_no_ar_ms / agora_ms, agora_ms / 1000);
+
+  bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && lora.quantidade == 0 && lora.descartados == 0 &&
+            lora.confirmados == lora.enviados;
+  puts(ok ? "OK" : "FALHOU");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Bancada do driver SSD1306 no RP2040: compara o template (lib/ssd1306.cpp) com a
+// implementação C (lib/ssd1306.c, ligada com prefixo c_) no mesmo firmware.
+//  1. Equivalência: primitivas aleatórias nos dois drivers, buffers comparados byte a byte.
+//  2. Desempenho: time_us_32 em volta de N chamadas de cada primitiva (o Cortex-M0+ não
+//     tem DWT), convertido em ciclos pelo clk_sys atual.
+// Nada é enviado pelo I2C. Resultado na saída serial; o tamanho de código sai do
+// arm-none-eabi-size dos firmwares com SSD1306_TEMPLATE=ON e OFF (veja o README).
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "lib/ssd1306.h"
+
+extern "C" {
+void c_ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+void c_ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
+void c_ssd1306_fill(ssd1306_t *ssd, bool value);
+void c_ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
+void c_ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
+void c_ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
+void c_ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+void c_ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
+void c_ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+}
+
+#define ITERACOES_EQUIVALENCIA 20000
+#define CHAMADAS 1000
+
+static ssd1306_t c, t;
+
+// Aplica a mesma primitiva aleatória aos dois drivers
+static void primitiva_aleatoria() {
+  int op = rand() % 7;
+  bool v = rand() % 2, cheio = rand() % 2;
+  int x0 = rand() % WIDTH, y0 = rand() % HEIGHT, x1 = rand() % WIDTH, y1 = rand() % HEIGHT;
+  switch (op) {
+  case 0:
+    c_ssd1306_pixel(&c, x0, y0, v);
+    ssd1306_pixel(&t, x0, y0, v);
+    break;
+  case 1:
+    if (x0 > x1)
+      std::swap(x0, x1);
+    c_ssd1306_hline(&c, x0, x1, y0, v);
+    ssd1306_hline(&t, x0, x1, y0, v);
+    break;
+  case 2:
+    if (y0 > y1)
+      std::swap(y0, y1);
+    c_ssd1306_vline(&c, x0, y0, y1, v);
+    ssd1306_vline(&t, x0, y0, y1, v);
+    break;
+  case 3: {
+    int w = 1 + rand() % (WIDTH - x0), h = 1 + rand() % (HEIGHT - y0);
+    c_ssd1306_rect(&c, y0, x0, w, h, v, cheio);
+    ssd1306_rect(&t, y0, x0, w, h, v, cheio);
+    break;
+  }
+  case 4:
+    c_ssd1306_line(&c, x0, y0, x1, y1, v);
+    ssd1306_line(&t, x0, y0, x1, y1, v);
+    break;
+  case 5: {
+    const char *s = "V. Lata:0.37 Umid.: 65% *";
+    int x = rand() % 100, y = rand() % 50;
+    c_ssd1306_draw_string(&c, s, x, y);
+    ssd1306_draw_string(&t, s, x, y);
+    break;
+  }
+  default:
+    c_ssd1306_fill(&c, v);
+    ssd1306_fill(&t, v);
+    break;
+  }
+}
+
+static bool equivalentes() {
+  srand(3);
+  for (int i = 0; i < ITERACOES_EQUIVALENCIA; ++i) {
+    primitiva_aleatoria();
+    if (memcmp(c.ram_buffer, t.ram_buffer, c.bufsize) != 0) {
+      printf("Diferença na iteração %d\n", i);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Tempo médio por chamada, em ciclos de clk_sys
+template <class F>
+static float ciclos(F f, int n) {
+  uint32_t inicio = time_us_32();
+  for (int i = 0; i < n; ++i)
+    f(i);
+  uint32_t us = time_us_32() - inicio;
+  return (float)us * (clock_get_hz(clk_sys) / 1000000u) / n;
+}
+
+template <class FC, class FT>
+static void medir(const char *nome, int n, FC fc, FT ft) {
+  float cc = ciclos(fc, n), ct = ciclos(ft, n);
+  printf("%-16s %12.0f %12.0f %7.2fx\n", nome, cc, ct, cc / ct);
+}
+
+int main() {
+  stdio_init_all();
+  sleep_ms(3000); // Tempo para abrir o terminal serial
+
+  c_ssd1306_init(&c, WIDTH, HEIGHT, false, 0x3C, i2c1);
+  ssd1306_init(&t, WIDTH, HEIGHT, false, 0x3C, i2c1);
+
+  while (true) {
+    printf("\n== Bancada SSD1306 (clk_sys %lu kHz) ==\n", (unsigned long)(clock_get_hz(clk_sys) / 1000));
+    printf("Equivalência em %d primitivas: %s\n", ITERACOES_EQUIVALENCIA, equivalentes() ? "OK" : "FALHOU");
+
+    printf("%-16s %12s %12s %8s\n", "primitiva", "C (ciclos)", "template", "ganho");
+    medir("fill", CHAMADAS / 10,
+          [](int i) { c_ssd1306_fill(&c, i & 1); }, [](int i) { ssd1306_fill(&t, i & 1); });
+    medir("pixel", CHAMADAS * 10,
+          [](int i) { c_ssd1306_pixel(&c, i & 127, i & 63, i & 1); }, [](int i) { ssd1306_pixel(&t, i & 127, i & 63, i & 1); });
+    medir("draw_char", CHAMADAS,
+          [](int i) { c_ssd1306_draw_char(&c, 'A' + (i & 15), 8, 18 + (i & 1) * 3); },
+          [](int i) { ssd1306_draw_char(&t, 'A' + (i & 15), 8, 18 + (i & 1) * 3); });
+    medir("draw_string", CHAMADAS,
+          [](int i) { c_ssd1306_draw_string(&c, "V. Est.:5.60", 8, 18 + (i & 1) * 3); },
+          [](int i) { ssd1306_draw_string(&t, "V. Est.:5.60", 8, 18 + (i & 1) * 3); });
+    medir("rect 122x60", CHAMADAS,
+          [](int i) { c_ssd1306_rect(&c, 3, 3, 122, 60, i & 1, false); }, [](int i) { ssd1306_rect(&t, 3, 3, 122, 60, i & 1, false); });
+    medir("rect cheio", CHAMADAS / 10,
+          [](int i) { c_ssd1306_rect(&c, 3, 3, 122, 60, i & 1, true); }, [](int i) { ssd1306_rect(&t, 3, 3, 122, 60, i & 1, true); });
+    medir("hline 128", CHAMADAS,
+          [](int i) { c_ssd1306_hline(&c, 0, 127, i & 63, i & 1); }, [](int i) { ssd1306_hline(&t, 0, 127, i & 63, i & 1); });
+    medir("vline 64", CHAMADAS,
+          [](int i) { c_ssd1306_vline(&c, i & 127, 0, 63, i & 1); }, [](int i) { ssd1306_vline(&t, i & 127, 0, 63, i & 1); });
+    medir("line", CHAMADAS,
+          [](int i) { c_ssd1306_line(&c, 0, 0, 127, 63, i & 1); }, [](int i) { ssd1306_line(&t, 0, 0, 127, 63, i & 1); });
+
+    sleep_ms(10000);
+  }
+}
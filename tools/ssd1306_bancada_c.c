@@ -0,0 +1,16 @@
+// lib/ssd1306.c com os símbolos prefixados por c_, para a bancada ligar os dois drivers
+// no mesmo firmware (o template em lib/ssd1306.cpp exporta os nomes originais)
+#define ssd1306_init c_ssd1306_init
+#define ssd1306_config c_ssd1306_config
+#define ssd1306_command c_ssd1306_command
+#define ssd1306_send_data c_ssd1306_send_data
+#define ssd1306_pixel c_ssd1306_pixel
+#define ssd1306_fill c_ssd1306_fill
+#define ssd1306_rect c_ssd1306_rect
+#define ssd1306_line c_ssd1306_line
+#define ssd1306_hline c_ssd1306_hline
+#define ssd1306_vline c_ssd1306_vline
+#define ssd1306_draw_char c_ssd1306_draw_char
+#define ssd1306_draw_string c_ssd1306_draw_string
+
+#include "lib/ssd1306.c"